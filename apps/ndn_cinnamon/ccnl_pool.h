@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Fixed-size pools for CCN-lite's prefixes, packets, content
+ *              and PIT entries
+ *
+ * CCN-lite allocates through malloc(), so the pools sit behind the linker's
+ * --wrap of malloc, calloc, realloc and free. Requests of exactly the size
+ * of one of the pooled structs are served from its pool, everything else
+ * and requests beyond an exhausted pool go to TLSF as before. Pooled blocks
+ * are recognised on free() by their address.
+ *
+ * The pools are dimensioned from CCNL_CACHE_SIZE, CCNL_QUEUE_SIZE, the PIT
+ * bound and COMPAS_NAM_CACHE_LEN. Their memory is taken from the TLSF heap,
+ * so the RAM used stays the same.
+ *
+ * @}
+ */
+
+#ifndef CCNL_POOL_H
+#define CCNL_POOL_H
+
+#include <stdbool.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* prefixes of the name cache */
+#ifdef COMPAS_NAM_CACHE_LEN
+#define CCNL_POOL_NAM_CACHE     (COMPAS_NAM_CACHE_LEN)
+#else
+#define CCNL_POOL_NAM_CACHE     (0)
+#endif
+
+/* PIT entries, one per queued Interest if the PIT is unbounded */
+#ifndef CCNL_POOL_PIT
+#if defined(CCNL_DEFAULT_MAX_PIT_ENTRIES) && (CCNL_DEFAULT_MAX_PIT_ENTRIES > 0)
+#define CCNL_POOL_PIT           (CCNL_DEFAULT_MAX_PIT_ENTRIES)
+#else
+#define CCNL_POOL_PIT           (CCNL_QUEUE_SIZE)
+#endif
+#endif
+
+/* content objects, plus the ones added before the eviction */
+#ifndef CCNL_POOL_CONTENT
+#define CCNL_POOL_CONTENT       (CCNL_CACHE_SIZE + 2)
+#endif
+
+/* packets of content objects and PIT entries, plus the ones in decoding */
+#ifndef CCNL_POOL_PKT
+#define CCNL_POOL_PKT           (CCNL_POOL_CONTENT + CCNL_POOL_PIT + 4)
+#endif
+
+/* FIB entries allocated by CCN-lite */
+#ifndef CCNL_POOL_FIB
+#define CCNL_POOL_FIB           (16)
+#endif
+
+/* prefixes of all packets, of the name cache and of the FIB */
+#ifndef CCNL_POOL_PREFIX
+#define CCNL_POOL_PREFIX        (CCNL_POOL_PKT + CCNL_POOL_NAM_CACHE + \
+                                 CCNL_POOL_FIB)
+#endif
+
+/* bytes of one pooled block of @p type */
+#define CCNL_POOL_BLOCK(type)   ((sizeof(type) + 7) & ~((size_t)7))
+
+/* bytes of all pools */
+#define CCNL_POOL_BYTES                                                     \
+    ((CCNL_POOL_PREFIX * CCNL_POOL_BLOCK(struct ccnl_prefix_s)) +           \
+     (CCNL_POOL_PKT * CCNL_POOL_BLOCK(struct ccnl_pkt_s)) +                 \
+     (CCNL_POOL_CONTENT * CCNL_POOL_BLOCK(struct ccnl_content_s)) +         \
+     (CCNL_POOL_PIT * CCNL_POOL_BLOCK(struct ccnl_interest_s)))
+
+/**
+ * @brief   Called with every block freed back into a pool serving struct
+ *          ccnl_content_s, before the block is reused
+ *
+ * Runs in the thread calling free(). Frees from other pools and from the
+ * heap are not reported.
+ */
+typedef void (*ccnl_pool_free_cb_t)(void *ptr);
+
+/**
+ * @brief   Install @p cb, NULL removes it
+ */
+void ccnl_pool_set_free_cb(ccnl_pool_free_cb_t cb);
+
+/**
+ * @brief   True if @p ptr is a block of a pool serving struct
+ *          ccnl_content_s, i.e. its free() is reported to the callback
+ */
+bool ccnl_pool_is_content(const void *ptr);
+
+/**
+ * @brief   Shell command printing use, high-water mark and failed
+ *          allocations of each pool, "reset" clears the latter two
+ */
+int ccnl_pool_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CCNL_POOL_H */
@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+
+#ifdef CCNL_POOLS
+#include "ccnl_pool.h"
+#endif
+#include "cs_idx.h"
+
+#define FNV_OFFSET              (2166136261U)
+#define FNV_PRIME               (16777619U)
+
+/* lookups per backend and number of entries in cs_idx_bench() */
+#ifndef CS_IDX_BENCH_LOOKUPS
+#define CS_IDX_BENCH_LOOKUPS    (10000U)
+#endif
+#define CS_IDX_BENCH_NAMES      (64U)
+
+static cs_idx_entry_t *_bucket[CS_IDX_BUCKETS];
+static cs_idx_entry_t _pool[CS_IDX_NUMOF];
+
+cs_idx_t cs_idx = {
+    .bucket = _bucket,
+    .mask = CS_IDX_BUCKETS - 1,
+    .pool = _pool,
+    .numof = CS_IDX_NUMOF,
+};
+
+/* cs_idx is looked up by the relay and pruned by whoever frees content */
+static mutex_t _lock = MUTEX_INIT;
+
+/* FNV-1a over the lengths and bytes of all components */
+static uint32_t _hash(struct ccnl_prefix_s *name)
+{
+    uint32_t hash = FNV_OFFSET;
+
+    for (int i = 0; i < name->compcnt; i++) {
+        hash = (hash ^ (uint32_t)name->complen[i]) * FNV_PRIME;
+        for (int j = 0; j < name->complen[i]; j++) {
+            hash = (hash ^ name->comp[i][j]) * FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+static int _equal(struct ccnl_prefix_s *a, struct ccnl_prefix_s *b)
+{
+    if (a->compcnt != b->compcnt) {
+        return 0;
+    }
+    /* the sequence number at the end differs first */
+    for (int i = a->compcnt - 1; i >= 0; i--) {
+        if ((a->complen[i] != b->complen[i]) ||
+            memcmp(a->comp[i], b->comp[i], a->complen[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static struct ccnl_content_s *_find(cs_idx_t *idx, struct ccnl_prefix_s *name,
+                                    uint32_t hash)
+{
+    for (cs_idx_entry_t *e = idx->bucket[hash & idx->mask]; e; e = e->next) {
+        if ((e->hash == hash) && _equal(e->c->pkt->pfx, name)) {
+            return e->c;
+        }
+    }
+    return NULL;
+}
+
+/* what the relay does per Interest: walk the whole list */
+static struct ccnl_content_s *_list_lookup(struct ccnl_content_s *contents,
+                                           struct ccnl_prefix_s *name)
+{
+    for (struct ccnl_content_s *c = contents; c; c = c->next) {
+        if (!ccnl_prefix_cmp(c->pkt->pfx, NULL, name, CMP_EXACT)) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static bool _indexed(cs_idx_t *idx, struct ccnl_content_s *c)
+{
+    uint32_t hash = _hash(c->pkt->pfx);
+
+    for (cs_idx_entry_t *e = idx->bucket[hash & idx->mask]; e; e = e->next) {
+        if (e->c == c) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* only frees of pool blocks are reported, other content could outlive its
+ * entry */
+static bool _reported(struct ccnl_content_s *c)
+{
+#ifdef CCNL_POOLS
+    return ccnl_pool_is_content(c);
+#else
+    (void)c;
+    return false;
+#endif
+}
+
+/* new content sits in front of the first indexed entry */
+static void _sync(cs_idx_t *idx, struct ccnl_content_s *contents)
+{
+    for (struct ccnl_content_s *c = contents; c && !_indexed(idx, c);
+         c = c->next) {
+        if (!_reported(c) || (cs_idx_add(idx, c) < 0)) {
+            idx->overflow = true;
+            return;
+        }
+    }
+}
+
+void cs_idx_init(cs_idx_t *idx, cs_idx_entry_t **bucket, unsigned buckets,
+                 cs_idx_entry_t *pool, unsigned numof)
+{
+    memset(bucket, 0, buckets * sizeof(*bucket));
+    idx->bucket = bucket;
+    idx->mask = buckets - 1;
+    idx->pool = pool;
+    idx->numof = numof;
+    idx->used = 0;
+    idx->free = NULL;
+    idx->num = 0;
+    idx->overflow = false;
+}
+
+int cs_idx_add(cs_idx_t *idx, struct ccnl_content_s *c)
+{
+    cs_idx_entry_t *e;
+
+    if (idx->free) {
+        e = idx->free;
+        idx->free = e->next;
+    }
+    else if (idx->used < idx->numof) {
+        e = &idx->pool[idx->used++];
+    }
+    else {
+        return -1;
+    }
+    e->c = c;
+    e->hash = _hash(c->pkt->pfx);
+    e->next = idx->bucket[e->hash & idx->mask];
+    idx->bucket[e->hash & idx->mask] = e;
+    idx->num++;
+    return 0;
+}
+
+void cs_idx_remove(cs_idx_t *idx, const void *c)
+{
+    /* the content may be gone already, so find it by address, not name */
+    for (unsigned i = 0; i < idx->used; i++) {
+        cs_idx_entry_t *e = &idx->pool[i];
+
+        if (e->c != c) {
+            continue;
+        }
+        for (cs_idx_entry_t **p = &idx->bucket[e->hash & idx->mask]; *p;
+             p = &(*p)->next) {
+            if (*p == e) {
+                *p = e->next;
+                break;
+            }
+        }
+        e->c = NULL;
+        e->next = idx->free;
+        idx->free = e;
+        idx->num--;
+        return;
+    }
+}
+
+#ifdef CCNL_POOLS
+static void _on_free(void *ptr)
+{
+    mutex_lock(&_lock);
+    if (cs_idx.num) {
+        cs_idx_remove(&cs_idx, ptr);
+    }
+    mutex_unlock(&_lock);
+}
+#endif
+
+void cs_idx_attach(void)
+{
+#ifdef CCNL_POOLS
+    ccnl_pool_set_free_cb(_on_free);
+#endif
+}
+
+struct ccnl_content_s *cs_idx_lookup(cs_idx_t *idx, struct ccnl_relay_s *relay,
+                                     struct ccnl_prefix_s *name)
+{
+    struct ccnl_content_s *c;
+
+    mutex_lock(&_lock);
+    if (!idx->overflow) {
+        _sync(idx, relay->contents);
+    }
+    if (idx->overflow) {
+        /* rebuild once the store fits again */
+        if (relay->contentcnt < (int)idx->numof) {
+            cs_idx_init(idx, idx->bucket, idx->mask + 1, idx->pool, idx->numof);
+            _sync(idx, relay->contents);
+        }
+    }
+    c = idx->overflow ? _list_lookup(relay->contents, name)
+                      : _find(idx, name, _hash(name));
+    mutex_unlock(&_lock);
+    return c;
+}
+
+int cs_idx_serve(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                 struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_content_s *c;
+
+    /* the app face is served through ccnl_app_RX(), left to the relay */
+    if (from->ifndx < 0) {
+        return 0;
+    }
+    c = cs_idx_lookup(&cs_idx, relay, pkt->pfx);
+    /* aged content, e.g. NACKs, is about to go, the relay decides on it */
+    if (!c || ((CCNL_NOW() - c->last_used) > CCNL_CONTENT_TIMEOUT)) {
+        return 0;
+    }
+    /* what the relay does on a CS hit */
+    ccnl_send_pkt(relay, from, c->pkt);
+    return 1;
+}
+
+static void _bench_print(unsigned n, const char *backend, uint32_t usec)
+{
+    /* CSBENCH;<entries>;<backend>;<lookups>;<usec>;<lookups/s> */
+    printf("CSBENCH;%u;%s;%u;%lu;%lu\n", n, backend, CS_IDX_BENCH_LOOKUPS,
+           (unsigned long)usec,
+           (unsigned long)(((uint64_t)CS_IDX_BENCH_LOOKUPS * US_PER_SEC) /
+                           (usec ? usec : 1)));
+}
+
+static void _bench(unsigned n)
+{
+    struct ccnl_content_s *c = calloc(n, sizeof(*c));
+    struct ccnl_pkt_s *pkt = calloc(n, sizeof(*pkt));
+    struct ccnl_prefix_s *names[CS_IDX_BENCH_NAMES] = { NULL };
+    unsigned buckets = 1;
+    cs_idx_entry_t **bucket;
+    cs_idx_entry_t *pool = calloc(n, sizeof(*pool));
+    cs_idx_t idx;
+    char uri[48];
+    unsigned miss = 0, i;
+    uint32_t start;
+
+    while (buckets < n) {
+        buckets <<= 1;
+    }
+    bucket = malloc(buckets * sizeof(*bucket));
+    if (!c || !pkt || !pool || !bucket) {
+        printf("CSBENCH;%u;out of memory\n", n);
+        goto out;
+    }
+    cs_idx_init(&idx, bucket, buckets, pool, n);
+    /* Data of 8 producers, newest first as the relay inserts it */
+    for (i = 0; i < n; i++) {
+        snprintf(uri, sizeof(uri), "/i3/00:00:00:00:00:00:00:%02x/gasval/%04u",
+                 i % 8, i / 8);
+        pkt[i].pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+        if (!pkt[i].pfx) {
+            printf("CSBENCH;%u;out of memory\n", n);
+            goto out;
+        }
+        c[i].pkt = &pkt[i];
+        c[i].next = (i + 1 < n) ? &c[i + 1] : NULL;
+        cs_idx_add(&idx, &c[i]);
+    }
+    /* every other request misses, as for Data not yet produced */
+    for (i = 0; i < CS_IDX_BENCH_NAMES; i++) {
+        unsigned e = (i * 7919U) % n;
+        snprintf(uri, sizeof(uri), "/i3/00:00:00:00:00:00:00:%02x/gasval/%04u",
+                 e % 8, (i & 1) ? (e / 8) + n : e / 8);
+        names[i] = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+        if (!names[i]) {
+            printf("CSBENCH;%u;out of memory\n", n);
+            goto out;
+        }
+    }
+
+    start = xtimer_now_usec();
+    for (i = 0; i < CS_IDX_BENCH_LOOKUPS; i++) {
+        if (!_list_lookup(c, names[i % CS_IDX_BENCH_NAMES])) {
+            miss++;
+        }
+    }
+    _bench_print(n, "list", xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (i = 0; i < CS_IDX_BENCH_LOOKUPS; i++) {
+        struct ccnl_prefix_s *name = names[i % CS_IDX_BENCH_NAMES];
+        if (!_find(&idx, name, _hash(name))) {
+            miss++;
+        }
+    }
+    _bench_print(n, "hash", xtimer_now_usec() - start);
+
+    miss = 0;
+    for (i = 0; i < CS_IDX_BENCH_NAMES; i++) {
+        if (_list_lookup(c, names[i]) != _find(&idx, names[i], _hash(names[i]))) {
+            miss++;
+        }
+    }
+    if (miss) {
+        printf("CSBENCH;%u;mismatch;%u\n", n, miss);
+    }
+
+out:
+    for (i = 0; i < CS_IDX_BENCH_NAMES; i++) {
+        if (names[i]) {
+            ccnl_prefix_free(names[i]);
+        }
+    }
+    if (pkt) {
+        for (i = 0; i < n; i++) {
+            if (pkt[i].pfx) {
+                ccnl_prefix_free(pkt[i].pfx);
+            }
+        }
+    }
+    free(bucket);
+    free(pool);
+    free(pkt);
+    free(c);
+}
+
+int cs_idx_bench(int argc, char **argv)
+{
+    static const unsigned sizes[] = { 10, 50, 200 };
+
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n <= 0) {
+            printf("usage: %s [entries]\n", argv[0]);
+            return 1;
+        }
+        _bench(n);
+        return 0;
+    }
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        _bench(sizes[i]);
+    }
+    return 0;
+}
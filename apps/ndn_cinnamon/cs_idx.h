@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Name hash index over the relay's content store
+ *
+ * The index only points into ccnl_relay.contents. CCN-lite inserts new
+ * content at the head of the list, from ccnl_content_add2cache() as well as
+ * for CCNL_MSG_ADD_CS, so a lookup first indexes the entries in front of
+ * the first one already indexed. Removals, whether by eviction, ageing or
+ * explicitly, all end in free(), where the CCNL_POOLS wrapper reports blocks
+ * of the content pool to the index before they are reused. That may happen
+ * in any thread, so cs_idx is locked for lookups and removals.
+ *
+ * If more content is cached than the index holds, or content was allocated
+ * from the heap because the pool was exhausted, lookups fall back to walking
+ * the list.
+ *
+ * The relay's own CS match runs inline in its Interest handling, after the
+ * local producer. cs_idx_serve() answers hits from that hook, so the relay
+ * never walks its list for them. A miss still costs the relay's walk, it
+ * has no hook after which it would skip it.
+ *
+ * @}
+ */
+
+#ifndef CS_IDX_H
+#define CS_IDX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of content objects indexed for the relay */
+#ifndef CS_IDX_NUMOF
+#define CS_IDX_NUMOF            (CCNL_CACHE_SIZE + 8)
+#endif
+
+/* number of hash buckets for the relay, must be a power of two */
+#ifndef CS_IDX_BUCKETS
+#define CS_IDX_BUCKETS          (64)
+#endif
+
+typedef struct cs_idx_entry {
+    struct cs_idx_entry *next;      /* next entry in the same bucket or free */
+    struct ccnl_content_s *c;
+    uint32_t hash;
+} cs_idx_entry_t;
+
+typedef struct {
+    cs_idx_entry_t **bucket;
+    unsigned mask;                  /* number of buckets - 1 */
+    cs_idx_entry_t *pool;
+    unsigned numof;
+    unsigned used;                  /* pool entries ever handed out */
+    cs_idx_entry_t *free;
+    unsigned num;                   /* entries indexed */
+    bool overflow;                  /* content was not indexed */
+} cs_idx_t;
+
+/**
+ * @brief   Index of ccnl_relay.contents
+ */
+extern cs_idx_t cs_idx;
+
+/**
+ * @brief   Set up an empty index on caller-provided memory
+ *
+ * @param[in] buckets   number of @p bucket, a power of two
+ */
+void cs_idx_init(cs_idx_t *idx, cs_idx_entry_t **bucket, unsigned buckets,
+                 cs_idx_entry_t *pool, unsigned numof);
+
+/**
+ * @brief   Let the CCNL_POOLS free() wrapper keep cs_idx consistent
+ */
+void cs_idx_attach(void);
+
+/**
+ * @brief   Add a content object to the index
+ *
+ * The caller serializes this with other uses of @p idx.
+ *
+ * @return  0 on success, -1 if the index is full
+ */
+int cs_idx_add(cs_idx_t *idx, struct ccnl_content_s *c);
+
+/**
+ * @brief   Drop the entry of @p c, which may already be freed
+ *
+ * The caller serializes this with other uses of @p idx.
+ */
+void cs_idx_remove(cs_idx_t *idx, const void *c);
+
+/**
+ * @brief   Find the content named @p name in @p relay's store
+ *
+ * Must be called from the relay thread.
+ */
+struct ccnl_content_s *cs_idx_lookup(cs_idx_t *idx, struct ccnl_relay_s *relay,
+                                     struct ccnl_prefix_s *name);
+
+/**
+ * @brief   Answer the Interest @p pkt from @p from if its name is cached
+ *
+ * Call last from the local producer and return the result, so the relay
+ * skips its CS walk on a hit. Interests of the app face and content older
+ * than CCNL_CONTENT_TIMEOUT are left to the relay.
+ *
+ * @return  1 if the content was sent, 0 otherwise
+ */
+int cs_idx_serve(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                 struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief   Shell command comparing lookups/s of the CS list and the index
+ *
+ * Runs for 10, 50 and 200 entries, or for the number given.
+ */
+int cs_idx_bench(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CS_IDX_H */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "fib_pfx.h"
+
+typedef struct {
+    struct ccnl_forward_s fwd;
+    struct ccnl_prefix_s pfx;
+    unsigned char *comp[FIB_PFX_COMPCNT];
+    int complen[FIB_PFX_COMPCNT];
+    unsigned char bytes[FIB_PFX_BYTES];
+} _entry_t;
+
+static _entry_t _pool[FIB_PFX_NUMOF];
+static unsigned _used;
+
+static int _equal(const _entry_t *e, const struct ccnl_prefix_s *name,
+                  int compcnt)
+{
+    if ((e->pfx.compcnt != compcnt) || (e->pfx.suite != name->suite)) {
+        return 0;
+    }
+    for (int i = 0; i < compcnt; i++) {
+        if ((e->complen[i] != name->complen[i]) ||
+            memcmp(e->comp[i], name->comp[i], e->complen[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+struct ccnl_forward_s *fib_pfx_find(const struct ccnl_prefix_s *name,
+                                    int compcnt)
+{
+    if (compcnt > name->compcnt) {
+        return NULL;
+    }
+    for (unsigned i = 0; i < _used; i++) {
+        if (_equal(&_pool[i], name, compcnt)) {
+            return &_pool[i].fwd;
+        }
+    }
+    return NULL;
+}
+
+struct ccnl_forward_s *fib_pfx_add(struct ccnl_relay_s *relay,
+                                   const struct ccnl_prefix_s *name,
+                                   int compcnt, struct ccnl_face_s *face)
+{
+    struct ccnl_forward_s **tail;
+    _entry_t *e;
+    int len = 0;
+
+    if ((_used >= FIB_PFX_NUMOF) || (compcnt > name->compcnt) ||
+        (compcnt > FIB_PFX_COMPCNT)) {
+        return NULL;
+    }
+    e = &_pool[_used];
+    for (int i = 0; i < compcnt; i++) {
+        if (len + name->complen[i] > FIB_PFX_BYTES) {
+            return NULL;
+        }
+        e->comp[i] = &e->bytes[len];
+        e->complen[i] = name->complen[i];
+        memcpy(e->comp[i], name->comp[i], name->complen[i]);
+        len += name->complen[i];
+    }
+    e->pfx.comp = e->comp;
+    e->pfx.complen = e->complen;
+    e->pfx.compcnt = compcnt;
+    e->pfx.suite = name->suite;
+    e->pfx.bytes = e->bytes;
+    e->fwd.prefix = &e->pfx;
+    e->fwd.face = face;
+    e->fwd.suite = name->suite;
+
+    /* append like ccnl_fib_add_entry(), the FIB order is the publish order */
+    for (tail = &relay->fib; *tail; tail = &(*tail)->next) {}
+    *tail = &e->fwd;
+    _used++;
+    return &e->fwd;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Pooled FIB entries for published prefixes
+ *
+ * A published name is truncated to its first components and copied into a
+ * preallocated FIB entry, which is appended to the relay's FIB like
+ * ccnl_fib_add_entry() does. No URI is formatted or parsed, nothing is
+ * allocated on the heap.
+ *
+ * Pooled entries are never freed. Their prefixes must therefore not be
+ * handed to ccnl_fib_add_entry() or ccnl_fib_rem_entry(), which would free
+ * them. Only the thread running the HoPP callbacks may add entries.
+ *
+ * @}
+ */
+
+#ifndef FIB_PFX_H
+#define FIB_PFX_H
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of pooled FIB entries */
+#ifndef FIB_PFX_NUMOF
+#define FIB_PFX_NUMOF           (64)
+#endif
+
+/* components per prefix, /PREFIX/<node> */
+#ifndef FIB_PFX_COMPCNT
+#define FIB_PFX_COMPCNT         (2)
+#endif
+
+/* bytes of all components of a prefix */
+#ifndef FIB_PFX_BYTES
+#define FIB_PFX_BYTES           (32)
+#endif
+
+/**
+ * @brief   Find the pooled entry whose prefix equals the first @p compcnt
+ *          components of @p name
+ */
+struct ccnl_forward_s *fib_pfx_find(const struct ccnl_prefix_s *name,
+                                    int compcnt);
+
+/**
+ * @brief   Append a FIB entry for the first @p compcnt components of
+ *          @p name to @p relay
+ *
+ * @return  the new entry, NULL if the pool is exhausted or the prefix too
+ *          long
+ */
+struct ccnl_forward_s *fib_pfx_add(struct ccnl_relay_s *relay,
+                                   const struct ccnl_prefix_s *name,
+                                   int compcnt, struct ccnl_face_s *face);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIB_PFX_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* netstats_l2 is only pulled in with L2_STATS, see the Makefile */
+#ifdef L2_STATS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/netapi.h"
+#include "net/netopt.h"
+#include "net/netstats.h"
+
+#include "l2_stats.h"
+
+static kernel_pid_t _netif = KERNEL_PID_UNDEF;
+static netstats_t _base;
+
+static netstats_t *_get(void)
+{
+    netstats_t *stats = NULL;
+
+    if ((_netif == KERNEL_PID_UNDEF) ||
+        (gnrc_netapi_get(_netif, NETOPT_STATS, NETSTATS_LAYER2, &stats,
+                         sizeof(&stats)) < 0)) {
+        return NULL;
+    }
+    return stats;
+}
+
+void l2_stats_init(kernel_pid_t netif)
+{
+    netstats_t *stats;
+
+    _netif = netif;
+    stats = _get();
+    if (stats) {
+        _base = *stats;
+    }
+}
+
+int l2_stats(int argc, char **argv)
+{
+    netstats_t *stats = _get();
+
+    if (!stats) {
+        puts("L2 counters unavailable");
+        return 1;
+    }
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        _base = *stats;
+        return 0;
+    }
+    uint32_t ucast = stats->tx_unicast_count - _base.tx_unicast_count;
+    uint32_t mcast = stats->tx_mcast_count - _base.tx_mcast_count;
+    uint32_t tx = ucast + mcast;
+
+    /* L2;<tx unicast>;<tx broadcast>;<unicast %>;<tx ok>;<tx failed>;
+     *    <tx bytes>;<rx>;<rx bytes> */
+    printf("L2;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n",
+           (unsigned long)ucast, (unsigned long)mcast,
+           (unsigned long)(tx ? (100 * (uint64_t)ucast) / tx : 0),
+           (unsigned long)(stats->tx_success - _base.tx_success),
+           (unsigned long)(stats->tx_failed - _base.tx_failed),
+           (unsigned long)(stats->tx_bytes - _base.tx_bytes),
+           (unsigned long)(stats->rx_count - _base.rx_count),
+           (unsigned long)(stats->rx_bytes - _base.rx_bytes));
+    return 0;
+}
+
+#endif /* L2_STATS */
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/pktbuf.h"
+#include "xtimer.h"
+
+#include "ccnl-pkt-builder.h"
+#include "latest.h"
+
+#define LATEST_PAYLOAD_MAX      (48)
+
+typedef struct {
+    bool known;
+    uint32_t seq;           /* newest item of the producer */
+    uint32_t due;           /* earliest time of the next item */
+} _node_t;
+
+static struct {
+    uint32_t answered;      /* producer */
+    uint32_t probes;
+    uint32_t replies;
+    uint32_t requests;
+    uint32_t held;          /* slots blind polling would have used */
+    uint32_t jumps;
+    uint32_t skipped;
+    uint32_t uncached;      /* answers received and kept out of the CS */
+} _stats;
+
+static _node_t _nodes[LATEST_NODES_NUMOF];
+
+static bool _produced;
+static uint32_t _seq;
+static uint32_t _produced_at;
+
+/* set while latest_answer() adds its own answer */
+static bool _answering;
+
+static void _put_u32(unsigned char *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static uint32_t _get_u32(const unsigned char *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool _comp_is(struct ccnl_prefix_s *name, int i, const char *s)
+{
+    return (name->complen[i] == (int)strlen(s)) &&
+           !memcmp(name->comp[i], s, name->complen[i]);
+}
+
+/* /<prefix>/<id>/latest */
+static bool _is_answer(struct ccnl_prefix_s *name)
+{
+    return (name->compcnt == 3) && _comp_is(name, 2, LATEST_COMP);
+}
+
+void latest_produced(unsigned seq)
+{
+    _seq = seq;
+    _produced_at = xtimer_now_usec();
+    _produced = true;
+}
+
+int latest_answer(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                  const char *prefix, const char *id)
+{
+    unsigned char buf[LATEST_PAYLOAD_MAX];
+    struct ccnl_prefix_s *name = pkt->pfx;
+    struct ccnl_content_s *c;
+    size_t id_len = strlen(id);
+    int len = LATEST_MAGIC_LEN + 9 + id_len;
+
+    if (!_produced || (name->compcnt != 3) || !_comp_is(name, 0, prefix) ||
+        !_comp_is(name, 1, id) || !_comp_is(name, 2, LATEST_COMP) ||
+        (len > LATEST_PAYLOAD_MAX)) {
+        return 0;
+    }
+    memcpy(buf, LATEST_MAGIC, LATEST_MAGIC_LEN);
+    _put_u32(&buf[LATEST_MAGIC_LEN], _seq);
+    _put_u32(&buf[LATEST_MAGIC_LEN + 4],
+             (xtimer_now_usec() - _produced_at) / US_PER_MS);
+    buf[LATEST_MAGIC_LEN + 8] = id_len;
+    memcpy(&buf[LATEST_MAGIC_LEN + 9], id, id_len);
+    c = ccnl_mkContentObject(name, buf, len, NULL);
+    if (!c) {
+        return 0;
+    }
+    /* stale right away, the next answer may differ */
+    c->last_used -= CCNL_CONTENT_TIMEOUT + 5;
+    _answering = true;
+    ccnl_content_add2cache(relay, c);
+    _answering = false;
+    _stats.answered++;
+    return 0;
+}
+
+int latest_cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    (void)relay;
+    if (_answering || !_is_answer(c->pkt->pfx)) {
+        return 1;
+    }
+    _stats.uncached++;
+    return 0;
+}
+
+void latest_init(void)
+{
+#ifndef CS_POLICY
+    ccnl_set_cache_strategy_cache(latest_cache);
+#endif
+}
+
+latest_action_t latest_next(unsigned idx, unsigned *seq)
+{
+    _node_t *n;
+
+    if (idx >= LATEST_NODES_NUMOF) {
+        _stats.requests++;
+        return LATEST_REQUEST;
+    }
+    n = &_nodes[idx];
+    if (n->known && (n->seq >= *seq)) {
+        if (n->seq > *seq) {
+            _stats.jumps++;
+            _stats.skipped += n->seq - *seq;
+            *seq = n->seq;
+        }
+        _stats.requests++;
+        return LATEST_REQUEST;
+    }
+    if (n->known && ((int32_t)(xtimer_now_usec() - n->due) < 0)) {
+        _stats.held++;
+        return LATEST_HOLD;
+    }
+    _stats.probes++;
+    return LATEST_PROBE;
+}
+
+int latest_parse(const unsigned char *data, size_t len,
+                 const unsigned char **id, size_t *id_len,
+                 uint32_t *seq, uint32_t *age_ms)
+{
+    if ((len < LATEST_MAGIC_LEN + 9) ||
+        memcmp(data, LATEST_MAGIC, LATEST_MAGIC_LEN) ||
+        (len < (size_t)LATEST_MAGIC_LEN + 9 + data[LATEST_MAGIC_LEN + 8])) {
+        return -1;
+    }
+    *seq = _get_u32(&data[LATEST_MAGIC_LEN]);
+    *age_ms = _get_u32(&data[LATEST_MAGIC_LEN + 4]);
+    *id_len = data[LATEST_MAGIC_LEN + 8];
+    *id = &data[LATEST_MAGIC_LEN + 9];
+    _stats.replies++;
+    return 0;
+}
+
+void latest_update(unsigned idx, uint32_t seq, uint32_t age_ms)
+{
+    _node_t *n;
+
+    if (idx >= LATEST_NODES_NUMOF) {
+        return;
+    }
+    n = &_nodes[idx];
+    /* a cached answer may be older than one already seen */
+    if (n->known && (seq < n->seq)) {
+        return;
+    }
+    n->known = true;
+    n->seq = seq;
+    n->due = xtimer_now_usec() - (age_ms * US_PER_MS) + LATEST_PERIOD_MIN;
+}
+
+/* only linked with -Wl,--wrap=ccnl_app_RX, see the Makefile */
+#ifdef LATEST
+int __real_ccnl_app_RX(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/* the package counts every Data handed up as an item received, answers go
+ * to the consumer thread only */
+int __wrap_ccnl_app_RX(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_prefix_s *name = c->pkt->pfx;
+    gnrc_pktsnip_t *pkt;
+
+    if (!_is_answer(name)) {
+        return __real_ccnl_app_RX(ccnl, c);
+    }
+    pkt = gnrc_pktbuf_add(NULL, c->pkt->content, c->pkt->contlen,
+                          GNRC_NETTYPE_CCN_CHUNK);
+    if (!pkt) {
+        return -1;
+    }
+    if (!gnrc_netapi_dispatch_receive(GNRC_NETTYPE_CCN_CHUNK,
+                                      GNRC_NETREG_DEMUX_CTX_ALL, pkt)) {
+        gnrc_pktbuf_release(pkt);
+    }
+    return 0;
+}
+#endif
+
+int latest_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    /* LATEST;<answered>;<probes>;<replies>;<requests>;<saved>;<jumps>;
+     *        <items skipped>;<not cached> */
+    printf("LATEST;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n",
+           (unsigned long)_stats.answered, (unsigned long)_stats.probes,
+           (unsigned long)_stats.replies, (unsigned long)_stats.requests,
+           (unsigned long)_stats.held, (unsigned long)_stats.jumps,
+           (unsigned long)_stats.skipped, (unsigned long)_stats.uncached);
+    return 0;
+}
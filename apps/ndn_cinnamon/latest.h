@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Discovery of a producer's newest sequence number
+ *
+ * CCN-lite matches neither CanBePrefix nor ChildSelector against its CS, so
+ * a consumer asks for /<prefix>/<id>/latest instead. The producer answers
+ * from its local producer function with a Data carrying the newest
+ * sequence number and how long ago it was produced. The producer adds the
+ * Data to its CS already stale, so the relay answers from there and evicts
+ * it first. Relays on the way back, the consumer's own included, must not
+ * cache it at all, or every later probe would get the same old answer
+ * without reaching the producer. latest_cache() keeps it out of their CS.
+ *
+ * The consumer requests only items it knows to exist and jumps straight to
+ * the newest one. Until the producer can have produced the next item, at
+ * least LATEST_PERIOD_MIN after the last one, it sends nothing for that
+ * producer, where blind polling would re-request the missing item every
+ * round.
+ *
+ * Answers reach the consumer thread past ccnl_app_RX(), where the package
+ * would count them as items received.
+ *
+ * @}
+ */
+
+#ifndef LATEST_H
+#define LATEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* last name component of a discovery Interest */
+#define LATEST_COMP             "latest"
+
+/* payload: "LATEST" <seq, 4 bytes> <age in ms, 4 bytes> <id length> <id> */
+#define LATEST_MAGIC            "LATEST"
+#define LATEST_MAGIC_LEN        (6)
+
+/* shortest time between two items of a producer */
+#ifndef LATEST_PERIOD_MIN
+#define LATEST_PERIOD_MIN       (15 * US_PER_SEC)
+#endif
+
+/* producers tracked by a consumer */
+#ifndef LATEST_NODES_NUMOF
+#define LATEST_NODES_NUMOF      (50)
+#endif
+
+/**
+ * @brief   What to send to a producer in its request slot
+ */
+typedef enum {
+    LATEST_REQUEST,         /**< request the item, it exists */
+    LATEST_PROBE,           /**< ask for the newest sequence number */
+    LATEST_HOLD,            /**< the next item cannot exist yet */
+} latest_action_t;
+
+/**
+ * @brief   Producer: item @p seq was just produced
+ */
+void latest_produced(unsigned seq);
+
+/**
+ * @brief   Producer: answer an Interest for /<@p prefix>/<@p id>/latest
+ *
+ * Call from the local producer function.
+ *
+ * @return  0, the relay answers from its CS
+ */
+int latest_answer(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                  const char *prefix, const char *id);
+
+/**
+ * @brief   Keep answers received from other nodes out of the CS
+ *
+ * Registered as the relay's cache strategy, unless CS_POLICY is set, whose
+ * strategy asks it instead.
+ */
+void latest_init(void);
+
+/**
+ * @brief   Cache strategy refusing received answers
+ *
+ * @return  0 if @p c is an answer from another node, 1 otherwise
+ */
+int latest_cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief   Consumer: decide what to send to producer @p idx
+ *
+ * @param[in,out] seq   next item not requested yet, moved to the newest
+ *                      known item on LATEST_REQUEST
+ */
+latest_action_t latest_next(unsigned idx, unsigned *seq);
+
+/**
+ * @brief   Parse and count an answer's payload
+ *
+ * @param[out] id       producer name component, not terminated
+ *
+ * @return  0 on success, -1 if @p data is no answer
+ */
+int latest_parse(const unsigned char *data, size_t len,
+                 const unsigned char **id, size_t *id_len,
+                 uint32_t *seq, uint32_t *age_ms);
+
+/**
+ * @brief   Consumer: producer @p idx answered with @p seq, @p age_ms old
+ */
+void latest_update(unsigned idx, uint32_t seq, uint32_t age_ms);
+
+/**
+ * @brief   Shell command printing answers, probes, requests and the
+ *          Interests saved compared with blind polling, "reset" clears them
+ */
+int latest_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATEST_H */
@@ -22,13 +22,57 @@
 #include "ccnl-pkt-builder.h"
 #include "net/hopp/hopp.h"
 
+#ifdef FIB_INDEX
+#include "fib_idx.h"
+#endif
+#ifdef FIB_POOL
+#include "fib_pfx.h"
+#endif
+#ifdef PIT_STATS
+#include "pit_stats.h"
+#endif
+#ifdef CS_POLICY
+#include "cs_policy.h"
+#endif
+#ifdef CCNL_POOLS
+#include "ccnl_pool.h"
+#endif
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef I3_TLV
+#include "i3_tlv.h"
+#endif
+#ifdef RELAY_Q
+#include "relay_q.h"
+#endif
+#ifdef LINK_LQ
+#include "link_lq.h"
+#endif
+#ifdef L2_STATS
+#include "l2_stats.h"
+#endif
+#ifdef REQ_SCHED
+#include "req_sched.h"
+#endif
+#ifdef LATEST
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "latest.h"
+#endif
+
 /* main thread's message queue */
 #define MAIN_QUEUE_SIZE     (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
 #ifdef MODULE_TLSF
 /* buffer for the heap should be enough for everyone */
+#ifdef CCNL_POOLS
+/* the pools take their memory from the heap */
+#define TLSF_BUFFER     ((41 * 1024 - CCNL_POOL_BYTES) / sizeof(uint32_t))
+#else
 #define TLSF_BUFFER     ((41 * 1024)/ sizeof(uint32_t))
+#endif
 static uint32_t _tlsf_heap[TLSF_BUFFER];
 #endif
 
@@ -133,15 +177,163 @@ void randomize(uint8_t arr[], int n) {
     }
 }
 
-void *_consumer_event_loop(void *arg)
+static struct ccnl_forward_s *_fwd_at(int idx)
+{
+    struct ccnl_forward_s *fwd;
+
+#ifdef FIB_INDEX
+    fwd = fib_idx_at(&fib_idx, idx);
+    if (fwd) {
+        return fwd;
+    }
+#endif
+    fwd = ccnl_relay.fib;
+    for(int j=0; j<idx; j++) {
+        fwd = fwd->next;
+    }
+    return fwd;
+}
+
+/* request the next content item of node idx */
+static void _request(int idx)
 {
-    (void)arg;
-    /* periodically request content items */
     char req_uri[40];
     char *a[2];
     char s[CCNL_MAX_PREFIX_SIZE];
     struct ccnl_forward_s *fwd;
+
+    /* select random fib entry */
+    fwd = _fwd_at(idx);
+    ccnl_prefix_to_str(fwd->prefix,s,CCNL_MAX_PREFIX_SIZE);
+    /* s consists of PREFIX and mac_id as it comes from the fib */
+    /* sort if nodeid_cont_cnt  and fib are eual because they've
+     * been created synchronously */
+    snprintf(req_uri, 40, "%s/gasval/%04d", s, nodeid_cont_cnt[idx][1]);
+
+#ifdef MODULE_PKTCNT_FAST
+    /* only print the first request. the value is 0 initially and
+     * if(!) will match*/
+    //if(!nodeid_cont_cnt[idx][2]) {
+        uint64_t now = xtimer_now_usec64();
+        printf("PUB;%s;%lu%06lu\n", req_uri,
+            (unsigned long)div_u64_by_1000000(now),
+            (unsigned long)now % US_PER_SEC);
+    //}
+    /* increment the number of retries, even though not all will actually
+     * be sent, because CCN-lite aggregates PIT if ccn-lite retransmissions
+     * are ongoing */
+#endif
+    nodeid_cont_cnt[idx][2]++;
+    a[1]= req_uri;
+    int ret=_ccnl_interest(2, (char **)a);
+    if(ret < 0) {
+        printf("ERROR sending interest: %i\n", ret);
+    }
+
+    /* if same ID for this node has been polled more than x times,
+     * drop it so we don't run out of sync */
+/*    if(nodeid_cont_cnt[idx][2] > 4) {
+        printf("DROP node %i cont %i\n", nodeid_cont_cnt[idx][0], nodeid_cont_cnt[idx][1]);
+        nodeid_cont_cnt[idx][1]++;
+        nodeid_cont_cnt[idx][2] = 0;
+        finished_counter++;
+    }*/
+}
+
+#ifdef LATEST
+#define LATEST_QUEUE_SIZE       (8)
+
+static msg_t _latest_queue[LATEST_QUEUE_SIZE];
+
+/* ask node idx for its newest sequence number */
+static void _probe(int idx)
+{
+    char req_uri[40];
+    char *a[2];
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    ccnl_prefix_to_str(_fwd_at(idx)->prefix, s, CCNL_MAX_PREFIX_SIZE);
+    snprintf(req_uri, sizeof(req_uri), "%s/%s", s, LATEST_COMP);
+    a[1] = req_uri;
+    int ret = _ccnl_interest(2, (char **)a);
+    if (ret < 0) {
+        printf("ERROR sending interest: %i\n", ret);
+    }
+}
+
+/* take the answers handed up since the last request, Data is ignored */
+static void _latest_drain(void)
+{
+    msg_t msg;
+
+    while (msg_try_receive(&msg) == 1) {
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        gnrc_pktsnip_t *pkt = msg.content.ptr;
+        const unsigned char *id;
+        size_t id_len;
+        uint32_t seq, age_ms;
+
+        if (!latest_parse(pkt->data, pkt->size, &id, &id_len, &seq, &age_ms)) {
+            int idx = 0;
+            for (struct ccnl_forward_s *fwd = ccnl_relay.fib; fwd;
+                 fwd = fwd->next, idx++) {
+                if ((fwd->prefix->compcnt > 1) &&
+                    (fwd->prefix->complen[1] == (int)id_len) &&
+                    !memcmp(fwd->prefix->comp[1], id, id_len)) {
+                    latest_update(idx, seq, age_ms);
+                    break;
+                }
+            }
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+}
+
+/* items jumped over, done without being requested */
+static int _skipped;
+
+/* request only items known to exist, jumping to the newest one. Like
+ * without LATEST, the package counts an item and moves on to the next once
+ * its Data arrived, so a lost Data is requested again. */
+static void _consume(int idx)
+{
+    unsigned seq = nodeid_cont_cnt[idx][1];
+
+    switch (latest_next(idx, &seq)) {
+        case LATEST_REQUEST:
+            if (seq >= NUM_REQUESTS_NODE) {
+                seq = NUM_REQUESTS_NODE - 1;
+            }
+            if (seq > nodeid_cont_cnt[idx][1]) {
+                _skipped += seq - nodeid_cont_cnt[idx][1];
+                nodeid_cont_cnt[idx][1] = seq;
+                nodeid_cont_cnt[idx][2] = 0;
+            }
+            _request(idx);
+            break;
+        case LATEST_PROBE:
+            _probe(idx);
+            break;
+        case LATEST_HOLD:
+            break;
+    }
+}
+#endif
+
+void *_consumer_event_loop(void *arg)
+{
+    (void)arg;
+    /* periodically request content items */
     uint32_t delay = 0;
+#ifdef LATEST
+    gnrc_netreg_entry_t ne = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                        sched_active_pid);
+
+    msg_init_queue(_latest_queue, LATEST_QUEUE_SIZE);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN_CHUNK, &ne);
+#endif
 
     xtimer_usleep(PRODUCER_DELAY);
 
@@ -153,54 +345,28 @@ void *_consumer_event_loop(void *arg)
         for (int i=0; i < nodes_num; i++) {
             /* only send interests to this node if max is not reached */
             if(nodeid_cont_cnt[indexes[i]][1] < NUM_REQUESTS_NODE) {
-                /* select random fib entry */
-                fwd = ccnl_relay.fib;
-                for(int j=0; j<indexes[i]; j++) {
-                    fwd = fwd->next;
-                }
                 /* send interest to that entry */
                 delay = (uint32_t)((float)REQ_DELAY/(float)nodes_num);
                 //printf("consumer sleep for %" PRIu32 " us\n", delay);
                 //delay = (uint32_t)((float)DELAY_REQUEST/(float)nodes_num);
                 xtimer_usleep(delay);
-                ccnl_prefix_to_str(fwd->prefix,s,CCNL_MAX_PREFIX_SIZE);
-                /* s consists of PREFIX and mac_id as it comes from the fib */
-                /* sort if nodeid_cont_cnt  and fib are eual because they've
-                 * been created synchronously */
-                snprintf(req_uri, 40, "%s/gasval/%04d", s, nodeid_cont_cnt[indexes[i]][1]);
-
-#ifdef MODULE_PKTCNT_FAST
-                /* only print the first request. the value is 0 initially and
-                 * if(!) will match*/
-                //if(!nodeid_cont_cnt[indexes[i]][2]) {
-                    uint64_t now = xtimer_now_usec64();
-                    printf("PUB;%s;%lu%06lu\n", req_uri,
-                        (unsigned long)div_u64_by_1000000(now),
-                        (unsigned long)now % US_PER_SEC);
-                //}
-                /* increment the number of retries, even though not all will actually
-                 * be sent, because CCN-lite aggregates PIT if ccn-lite retransmissions
-                 * are ongoing */
-#endif
-                nodeid_cont_cnt[indexes[i]][2]++;
-                a[1]= req_uri;
-                int ret=_ccnl_interest(2, (char **)a);
-                if(ret < 0) {
-                    printf("ERROR sending interest: %i\n", ret);
-                }
-
-                /* if same ID for this node has been polled more than x times,
-                 * drop it so we don't run out of sync */
-/*                if(nodeid_cont_cnt[indexes[i]][2] > 4) {
-                    printf("DROP node %i cont %i\n", nodeid_cont_cnt[indexes[i]][0], nodeid_cont_cnt[indexes[i]][1]);
-                    nodeid_cont_cnt[indexes[i]][1]++;
-                    nodeid_cont_cnt[indexes[i]][2] = 0;
-                    finished_counter++;
-                }*/
+#ifdef LATEST
+                _latest_drain();
+                _consume(indexes[i]);
+#else
+                _request(indexes[i]);
+#endif
             }
-            if (finished_counter == (nodes_num * NUM_REQUESTS_NODE)) {
+#ifdef LATEST
+            if ((finished_counter + _skipped) >= (nodes_num * NUM_REQUESTS_NODE)) {
+#else
+            if (finished_counter >= (nodes_num * NUM_REQUESTS_NODE)) {
+#endif
                 xtimer_sleep(15);
                 puts("EXP DONE");
+#ifdef LATEST
+                gnrc_netreg_unregister(GNRC_NETTYPE_CCN_CHUNK, &ne);
+#endif
                 return 0;
             }
         }
@@ -208,6 +374,35 @@ void *_consumer_event_loop(void *arg)
     return 0;
 }
 
+#ifdef REQ_SCHED
+static bool _sched_send(unsigned i, unsigned count)
+{
+    (void)count;
+    /* the content ID only advances when the Data arrived */
+    if (nodeid_cont_cnt[indexes[i]][1] >= NUM_REQUESTS_NODE) {
+        return false;
+    }
+    _request(indexes[i]);
+    return true;
+}
+
+/* every node is requested once per REQ_DELAY, as in the serial loop */
+static uint32_t _sched_period(void)
+{
+    return REQ_DELAY;
+}
+
+void *_sched_event_loop(void *arg)
+{
+    (void)arg;
+
+    xtimer_usleep(PRODUCER_DELAY);
+    req_sched_run(nodes_num, _sched_send, _sched_period);
+    xtimer_sleep(15);
+    puts("EXP DONE");
+    return 0;
+}
+#endif
 
 static int _req_start(int argc, char **argv)
 {
@@ -215,10 +410,17 @@ static int _req_start(int argc, char **argv)
     (void)argv;
 
     memset(hopp_stack, 0, HOPP_STACKSZ);
+#ifdef REQ_SCHED
+    thread_create(hopp_stack, sizeof(hopp_stack),
+                  CONSUMER_THREAD_PRIORITY,
+                  THREAD_CREATE_STACKTEST, _sched_event_loop,
+                  NULL, "consumer");
+#else
     thread_create(hopp_stack, sizeof(hopp_stack),
                   CONSUMER_THREAD_PRIORITY,
                   THREAD_CREATE_STACKTEST, _consumer_event_loop,
                   NULL, "consumer");
+#endif
     return 0;
 }
 
@@ -266,6 +468,9 @@ int produce_cont_and_cache(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt, i
     m.content.ptr = (void *)c;
     //msg_send_receive(&m, &m, _ccnl_event_loop_pid);
     msg_send(&m, _ccnl_event_loop_pid);
+#ifdef LATEST
+    latest_produced(id);
+#endif
     //ccnl_content_add2cache(relay, c);
     return (int)m.content.value;
 }
@@ -329,6 +534,44 @@ static int _hopp_end(int argc, char **argv) {
     return 0;
 }
 
+#ifdef FIB_POOL
+static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                         struct ccnl_face_s *from)
+{
+    struct ccnl_prefix_s *name = pkt->pfx;
+    struct ccnl_forward_s *fwd;
+    char id[32];
+    int len;
+
+    printf("PUBLISHED: /%.*s/%.*s\n", name->complen[0], name->comp[0],
+                                      name->complen[1], name->comp[1]);
+#ifdef FIB_INDEX
+    fwd = fib_idx_find(&fib_idx, name, 2);
+#else
+    fwd = fib_pfx_find(name, 2);
+#endif
+    from->flags |= CCNL_FACE_FLAGS_STATIC;
+    if (fwd) {
+        /* republished prefix, only its face may have changed */
+        fwd->face = from;
+        return;
+    }
+    if (!fib_pfx_add(relay, name, 2, from)) {
+        puts("FIB FULL");
+        return;
+    }
+    /* fill array with node ids */
+    len = (name->complen[1] < (int)sizeof(id)) ? name->complen[1]
+                                               : (int)sizeof(id) - 1;
+    memcpy(id, name->comp[1], len);
+    id[len] = '\0';
+    nodeid_cont_cnt[fib_fill_cnt++][0]=atoi(id);
+    nodes_num++;
+#ifdef FIB_INDEX
+    fib_idx_sync(&fib_idx, relay->fib);
+#endif
+}
+#else
 static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
                          struct ccnl_face_s *from)
 {
@@ -340,6 +583,15 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
              "/%.*s/%.*s", pkt->pfx->complen[0], pkt->pfx->comp[0],
                            pkt->pfx->complen[1], pkt->pfx->comp[1]);
     printf("PUBLISHED: %s\n", scratch);
+#ifdef FIB_INDEX
+    /* republished prefix, only its face may have changed */
+    struct ccnl_forward_s *fwd = fib_idx_find(&fib_idx, pkt->pfx, 2);
+    if (fwd) {
+        from->flags |= CCNL_FACE_FLAGS_STATIC;
+        fwd->face = from;
+        return;
+    }
+#endif
     prefix = ccnl_URItoPrefix(scratch, CCNL_SUITE_NDNTLV, NULL, NULL);
 
     /* fill array with node ids */
@@ -355,9 +607,13 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
     }
     else{
         nodes_num++;
+#ifdef FIB_INDEX
+        fib_idx_sync(&fib_idx, relay->fib);
+#endif
     }
     ccnl_prefix_free(prefix);
 }
+#endif
 
 static int _publish(int argc, char **argv)
 {
@@ -401,12 +657,72 @@ static int _pktcnt_start(int argc, char **argv) {
 }
 #endif
 
+#if defined(PIT_STATS) || defined(CS_POLICY) || defined(LATEST) || \
+    defined(CS_INDEX)
+/* local producer that only samples the relay's tables and never answers,
+ * except for the newest sequence number and, with CS_INDEX, cached
+ * content */
+static int _sample_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                            struct ccnl_pkt_s *pkt)
+{
+    (void)from;
+#ifdef PIT_STATS
+    pit_stats_sample(relay, from, pkt);
+#endif
+#ifdef CS_POLICY
+    cs_policy_sample(relay, pkt);
+#endif
+#ifdef LATEST
+    latest_answer(relay, pkt, PREFIX, my_hwaddr_str);
+#endif
+#ifdef CS_INDEX
+    return cs_idx_serve(relay, from, pkt);
+#else
+    return 0;
+#endif
+}
+#endif
+
 static const shell_command_t shell_commands[] = {
     { "hr", "start HoPP root", _root },
     { "hp", "publish data", _publish },
     { "he", "HoPP end", _hopp_end },
     { "req_start", "start periodic content requests", _req_start },
     { "prod_start", "start periodic content creation", _prod_start },
+#ifdef REQ_SCHED
+    { "sched", "print request scheduling lateness, \"sched reset\" clears it", req_sched_stats },
+#endif
+#ifdef FIB_INDEX
+    { "fib_bench", "benchmark FIB lookups, list vs. hash index", fib_idx_bench },
+#endif
+#ifdef CS_POLICY
+    { "cs", "print content store counters, \"cs reset\" clears them", cs_policy_stats },
+#endif
+#ifdef PIT_STATS
+    { "pit", "print PIT counters, \"pit reset\" clears them", pit_stats },
+#endif
+#ifdef CCNL_POOLS
+    { "pools", "print CCN-lite pool use, \"pools reset\" clears it", ccnl_pool_stats },
+#endif
+#ifdef CS_INDEX
+    { "cs_bench", "benchmark CS lookups, list vs. hash index", cs_idx_bench },
+#endif
+#ifdef I3_TLV
+    { "tlv", "print packets decoded on the i3 fast path, \"tlv reset\" clears them", i3_tlv_stats },
+    { "tlv_bench", "benchmark NDN-TLV decoding, generic vs. i3 fast path", i3_tlv_bench },
+#endif
+#ifdef LATEST
+    { "latest", "print sequence number discovery counters, \"latest reset\" clears them", latest_stats },
+#endif
+#ifdef RELAY_Q
+    { "relayq", "print received frames queued and dropped per class, \"relayq reset\" clears them", relay_q_stats },
+#endif
+#ifdef LINK_LQ
+    { "link", "print rank changes, delivery ratio and link quality per neighbour, \"link reset\" clears them", link_lq_stats },
+#endif
+#ifdef L2_STATS
+    { "l2", "print link-layer unicast and broadcast frames, \"l2 reset\" clears them", l2_stats },
+#endif
 #ifdef MODULE_PKTCNT_FAST
     { "pktcnt_p", "print variables of pktcnt_fast module", _pktcnt_p },
 #else
@@ -428,17 +744,43 @@ int main(void)
     ccnl_core_init();
 
     ccnl_start();
+#ifdef CS_POLICY
+    cs_policy_init();
+#endif
+#ifdef LATEST
+    latest_init();
+#endif
+#ifdef CS_INDEX
+    cs_idx_attach();
+#endif
 
     /* get the default interface */
     gnrc_netif_t *netif = gnrc_netif_iter(NULL);
 
     gnrc_netapi_set(netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
 
-    /* set the relay's PID, configure the interface to use CCN nettype */
+    /* set the relay's PID, configure the interface to use CCN nettype.
+     * CCN-lite copies every received frame into a ccnl_buf_s, whose bytes
+     * are inline, and every packet it sends into a new snip. Both copies
+     * are inside the package's RIOT adaptation, wrapping ccnl_ll_TX() only
+     * sees the finished buffer, so the app cannot remove them. */
     if (ccnl_open_netif(netif->pid, GNRC_NETTYPE_CCN) < 0) {
         puts("Error registering at network interface!");
         return -1;
     }
+#ifdef L2_STATS
+    l2_stats_init(netif->pid);
+#endif
+#ifdef RELAY_Q
+    if (relay_q_init() < 0) {
+        return -1;
+    }
+#endif
+#ifdef LINK_LQ
+    if (link_lq_init(netif->pid) < 0) {
+        return -1;
+    }
+#endif
 
 #ifdef MODULE_GNRC_PKTDUMP
     gnrc_netreg_entry_t dump = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
@@ -446,6 +788,11 @@ int main(void)
     gnrc_netreg_register(GNRC_NETTYPE_CCN_CHUNK, &dump);
 #endif
 
+#if defined(PIT_STATS) || defined(CS_POLICY) || defined(LATEST) || \
+    defined(CS_INDEX)
+    ccnl_set_local_producer(_sample_producer);
+#endif
+
     /* save hw address globally */
 #ifdef BOARD_NATIVE
     gnrc_netapi_get(netif->pid, NETOPT_ADDRESS, 0, my_hwaddr, sizeof(my_hwaddr));
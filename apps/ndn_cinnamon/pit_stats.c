@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* only linked with the wraps of ccnl_interest_new and
+ * ccnl_content_serve_pending, see the Makefile */
+#ifdef PIT_STATS
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pit_stats.h"
+
+typedef struct {
+    uint32_t interests;
+    uint32_t cmps;              /* PIT entries compared for all Interests */
+    uint32_t aggregated;        /* matched an entry pending for other faces */
+    uint32_t retransmitted;     /* matched an entry pending for the same face */
+    uint32_t full;              /* Interests that found the PIT full */
+    uint32_t added;             /* entries created */
+    uint32_t satisfied;         /* entries removed when Data served them */
+    int base;                   /* PIT size when the counters were cleared */
+    uint64_t occ_sum;           /* PIT size summed over all samples */
+    unsigned hwm;
+} _stats_t;
+
+static _stats_t _stats;
+
+struct ccnl_interest_s *__real_ccnl_interest_new(struct ccnl_relay_s *relay,
+                                                 struct ccnl_face_s *from,
+                                                 struct ccnl_pkt_s **pkt);
+int __real_ccnl_content_serve_pending(struct ccnl_relay_s *relay,
+                                      struct ccnl_content_s *c);
+
+static bool _pending_for(struct ccnl_interest_s *i, struct ccnl_face_s *face)
+{
+    for (struct ccnl_pendint_s *pi = i->pending; pi; pi = pi->next) {
+        if (pi->face == face) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void pit_stats_sample(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_pkt_s *pkt)
+{
+    _stats.interests++;
+    _stats.occ_sum += relay->pitcnt;
+    if ((unsigned)relay->pitcnt > _stats.hwm) {
+        _stats.hwm = relay->pitcnt;
+    }
+    if ((relay->max_pit_entries >= 0) &&
+        (relay->pitcnt >= relay->max_pit_entries)) {
+        _stats.full++;
+    }
+    for (struct ccnl_interest_s *i = relay->pit; i; i = i->next) {
+        _stats.cmps++;
+        /* the relay stops at the first match as well */
+        if (!ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) {
+            if (_pending_for(i, from)) {
+                _stats.retransmitted++;
+            }
+            else {
+                _stats.aggregated++;
+            }
+            break;
+        }
+    }
+}
+
+/* both are called from the forwarding module, so --wrap sees every call.
+ * ccnl_interest_remove() is not wrapped, the relay module calls it
+ * internally. */
+struct ccnl_interest_s *__wrap_ccnl_interest_new(struct ccnl_relay_s *relay,
+                                                 struct ccnl_face_s *from,
+                                                 struct ccnl_pkt_s **pkt)
+{
+    int before = relay->pitcnt;
+    struct ccnl_interest_s *i = __real_ccnl_interest_new(relay, from, pkt);
+
+    if (relay->pitcnt > before) {
+        _stats.added++;
+    }
+    return i;
+}
+
+int __wrap_ccnl_content_serve_pending(struct ccnl_relay_s *relay,
+                                      struct ccnl_content_s *c)
+{
+    int before = relay->pitcnt;
+    int res = __real_ccnl_content_serve_pending(relay, c);
+
+    if (relay->pitcnt < before) {
+        _stats.satisfied += before - relay->pitcnt;
+    }
+    return res;
+}
+
+int pit_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        _stats.base = ccnl_relay.pitcnt;
+        return 0;
+    }
+    unsigned n = _stats.interests ? _stats.interests : 1;
+    /* whatever left the PIT without being served timed out or ran out of
+     * retransmissions */
+    int removed = _stats.base + (int)_stats.added - ccnl_relay.pitcnt;
+    int expired = removed - (int)_stats.satisfied;
+    unsigned occ = (unsigned)((_stats.occ_sum * 10) / n);
+    unsigned cmps = (unsigned)(((uint64_t)_stats.cmps * 10) / n);
+
+    /* PIT;<size>;<hwm>;<max>;<avg size>;<interests>;<avg cmps>;<aggregated>;
+     *     <full>;<expired>;<retransmitted>;<satisfied> */
+    printf("PIT;%d;%u;%d;%u.%u;%lu;%u.%u;%lu;%lu;%lu;%lu;%lu\n",
+           ccnl_relay.pitcnt, _stats.hwm, ccnl_relay.max_pit_entries,
+           occ / 10, occ % 10, (unsigned long)_stats.interests,
+           cmps / 10, cmps % 10, (unsigned long)_stats.aggregated,
+           (unsigned long)_stats.full,
+           (unsigned long)((expired > 0) ? expired : 0),
+           (unsigned long)_stats.retransmitted,
+           (unsigned long)_stats.satisfied);
+    return 0;
+}
+
+#endif /* PIT_STATS */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "net/hopp/hopp.h"
+#include "batch.h"
+#ifdef PUB_Q
+#include "pub_q.h"
+#endif
+#ifdef PUB_ZC
+#include "pub_zc.h"
+#endif
+
+#define BATCH_NAME_LEN          (80)
+/* {"id":"<sensor>","val":[<up to 5 digits>,...]} */
+#define BATCH_PAYLOAD_LEN       (32 + (BATCH_SIZE * 6))
+
+static struct {
+    uint32_t readings;
+    uint32_t sent;          /* readings published */
+    uint32_t published;
+    uint32_t full;
+    uint32_t timeouts;
+    uint64_t held;          /* us, summed over all published readings */
+    uint32_t held_max;
+} _stats;
+
+static unsigned _seq[BATCH_SIZE];
+static unsigned _val[BATCH_SIZE];
+static uint32_t _at[BATCH_SIZE];
+static unsigned _num;
+
+static const char *_prefix;
+static const char *_id;
+static const char *_sensor;
+
+static char _name[BATCH_NAME_LEN];
+#ifdef PUB_ZC
+/* formatted in place, pub_zc encodes the Data around it */
+static unsigned char _buf[PUB_ZC_BUF_SIZE(BATCH_PAYLOAD_LEN)];
+static char *const _payload = (char *)&_buf[PUB_ZC_HEADROOM];
+#else
+static char _payload[BATCH_PAYLOAD_LEN];
+#endif
+
+static void _sleep(uint32_t usec)
+{
+#ifdef PUB_Q
+    pub_q_sleep(usec);
+#else
+    xtimer_usleep(usec);
+#endif
+}
+
+#ifdef MODULE_PKTCNT_FAST
+static void _log(const char *what, const char *name)
+{
+    uint64_t now = xtimer_now_usec64();
+    printf("%s;%s;%lu%06lu\n", what, name,
+        (unsigned long)div_u64_by_1000000(now),
+        (unsigned long)now % US_PER_SEC);
+}
+#endif
+
+void batch_init(const char *prefix, const char *id, const char *sensor)
+{
+    _prefix = prefix;
+    _id = id;
+    _sensor = sensor;
+}
+
+void batch_flush(void)
+{
+    uint32_t now = xtimer_now_usec();
+    int name_len, len;
+
+    if (!_num) {
+        return;
+    }
+    if (_num == 1) {
+        name_len = snprintf(_name, sizeof(_name), "/%s/%s/gasval/%04u",
+                            _prefix, _id, _seq[0]);
+    }
+    else {
+        name_len = snprintf(_name, sizeof(_name), "/%s/%s/gasval/%04u-%04u",
+                            _prefix, _id, _seq[0], _seq[_num - 1]);
+    }
+    len = snprintf(_payload, BATCH_PAYLOAD_LEN, "{\"id\":\"%s\",\"val\":[",
+                   _sensor);
+    for (unsigned i = 0; i < _num; i++) {
+        uint32_t held = now - _at[i];
+
+        len += snprintf(&_payload[len], BATCH_PAYLOAD_LEN - len, "%s%u",
+                        i ? "," : "", _val[i]);
+        _stats.held += held;
+        if (held > _stats.held_max) {
+            _stats.held_max = held;
+        }
+    }
+    len += snprintf(&_payload[len], BATCH_PAYLOAD_LEN - len, "]}");
+#ifdef MODULE_PKTCNT_FAST
+    _log("PUB", _name);
+#endif
+#if defined(PUB_ZC)
+    pub_zc_publish(_name, name_len, _buf, len);
+#elif defined(PUB_Q)
+    pub_q_publish(_name, name_len, (unsigned char *)_payload, len);
+#else
+    hopp_publish_content(_name, name_len, (unsigned char *)_payload, len);
+#endif
+    _stats.sent += _num;
+    _stats.published++;
+    _num = 0;
+}
+
+void batch_add(unsigned seq, unsigned val)
+{
+#ifdef MODULE_PKTCNT_FAST
+    char name[BATCH_NAME_LEN];
+
+    snprintf(name, sizeof(name), "/%s/%s/gasval/%04u", _prefix, _id, seq);
+    _log("READ", name);
+#endif
+    _seq[_num] = seq;
+    _val[_num] = val;
+    _at[_num] = xtimer_now_usec();
+    _num++;
+    _stats.readings++;
+    if (_num == BATCH_SIZE) {
+        _stats.full++;
+        batch_flush();
+    }
+}
+
+void batch_sleep(uint32_t usec)
+{
+    uint32_t until = xtimer_now_usec() + usec;
+
+    while (_num) {
+        uint32_t due = _at[0] + (BATCH_TIMEOUT * US_PER_MS);
+
+        if ((int32_t)(until - due) < 0) {
+            break;
+        }
+        if ((int32_t)(due - xtimer_now_usec()) > 0) {
+            _sleep(due - xtimer_now_usec());
+        }
+        _stats.timeouts++;
+        batch_flush();
+    }
+    if ((int32_t)(until - xtimer_now_usec()) > 0) {
+        _sleep(until - xtimer_now_usec());
+    }
+}
+
+int batch_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    /* BATCH;<size>;<timeout ms>;<readings>;<publications>;<full>;
+     *       <timed out>;<mean hold ms>;<max hold ms> */
+    printf("BATCH;%u;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n", BATCH_SIZE,
+           (unsigned long)BATCH_TIMEOUT, (unsigned long)_stats.readings,
+           (unsigned long)_stats.published, (unsigned long)_stats.full,
+           (unsigned long)_stats.timeouts,
+           (unsigned long)(_stats.sent ?
+                           (_stats.held / _stats.sent) / US_PER_MS : 0),
+           (unsigned long)(_stats.held_max / US_PER_MS));
+    return 0;
+}
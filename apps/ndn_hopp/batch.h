@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Several sensor readings per HoPP publication
+ *
+ * Every hopp_publish_content() call propagates a NAM up the DODAG. A batch
+ * collects up to BATCH_SIZE readings and publishes them under one name
+ * covering their sequence numbers, /<prefix>/<id>/gasval/<first>-<last>,
+ * with all values in the payload. A batch is also published once its
+ * oldest reading has waited BATCH_TIMEOUT, so a reading is never held
+ * longer than that. A batch of one reading keeps the plain name.
+ *
+ * With MODULE_PKTCNT_FAST every reading prints READ;<name>;<time> when it
+ * is taken, and every publication prints PUB;<name>;<time> as usual. The
+ * latency of a reading is the RECV of the name covering it minus its READ.
+ *
+ * @}
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* readings per publication */
+#ifndef BATCH_SIZE
+#define BATCH_SIZE              (2)
+#endif
+
+/* bytes of a 127 byte IEEE 802.15.4 frame left for the Data, after the MAC
+ * header with both addresses long and the FCS */
+#ifndef BATCH_FRAME_LEN
+#define BATCH_FRAME_LEN         (104)
+#endif
+
+/* length of the node's name component, an EUI-64 as a string */
+#ifndef BATCH_ID_LEN
+#define BATCH_ID_LEN            (23)
+#endif
+
+/* length of the sensor id in the payload */
+#ifndef BATCH_SENSOR_LEN
+#define BATCH_SENSOR_LEN        (12)
+#endif
+
+/* Data, Name, MetaInfo and Content headers, the signature and the name
+ * /i3/<id>/gasval/<first>-<last> with four digit sequence numbers */
+#define BATCH_DATA_OVERHEAD     (2 + 2 + (4 * 2) + 2 + BATCH_ID_LEN + 6 + 9 + \
+                                 2 + 2 + 7)
+
+/* {"id":"<sensor>","val":[]} around the values */
+#define BATCH_PAYLOAD_FIXED     (18 + BATCH_SENSOR_LEN)
+
+/* values of up to 5 digits, each but the first after a comma, must still
+ * fit a single frame */
+#define BATCH_SIZE_MAX          ((BATCH_FRAME_LEN - BATCH_DATA_OVERHEAD - \
+                                  BATCH_PAYLOAD_FIXED + 1) / 6)
+
+#if (BATCH_SIZE < 1) || (BATCH_SIZE > BATCH_SIZE_MAX)
+#error "BATCH_SIZE must be between 1 and BATCH_SIZE_MAX"
+#endif
+
+/* longest time the oldest reading of a batch waits, in ms */
+#ifndef BATCH_TIMEOUT
+#define BATCH_TIMEOUT           (60000U)
+#endif
+
+/**
+ * @brief   Set the name components the batches are published under
+ *
+ * @param[in] prefix    first name component, without slash
+ * @param[in] id        this node's name component
+ * @param[in] sensor    sensor id carried in the payload
+ */
+void batch_init(const char *prefix, const char *id, const char *sensor);
+
+/**
+ * @brief   Add reading @p seq with value @p val, publish if the batch is full
+ */
+void batch_add(unsigned seq, unsigned val);
+
+/**
+ * @brief   Sleep for @p usec, publishing the batch when it times out
+ */
+void batch_sleep(uint32_t usec);
+
+/**
+ * @brief   Publish the readings collected so far, if any
+ */
+void batch_flush(void);
+
+/**
+ * @brief   Shell command printing readings, publications and how long
+ *          readings were held, "reset" clears them
+ */
+int batch_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BATCH_H */
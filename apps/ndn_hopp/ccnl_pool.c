@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* only linked with -Wl,--wrap=malloc etc., see the Makefile */
+#ifdef CCNL_POOLS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+
+#include "ccnl_pool.h"
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+typedef struct _block {
+    struct _block *next;
+} _block_t;
+
+typedef struct {
+    const char *name;
+    size_t size;                /* object size served */
+    size_t block;
+    unsigned numof;
+    uint8_t *mem;
+    _block_t *free;
+    unsigned next;              /* first block never handed out */
+    unsigned used;
+    unsigned high;
+    unsigned fails;
+} _pool_t;
+
+#define _MEM(type, numof) \
+    ((numof) * CCNL_POOL_BLOCK(type) / sizeof(uint64_t))
+
+static uint64_t _prefix_mem[_MEM(struct ccnl_prefix_s, CCNL_POOL_PREFIX)];
+static uint64_t _pkt_mem[_MEM(struct ccnl_pkt_s, CCNL_POOL_PKT)];
+static uint64_t _content_mem[_MEM(struct ccnl_content_s, CCNL_POOL_CONTENT)];
+static uint64_t _pit_mem[_MEM(struct ccnl_interest_s, CCNL_POOL_PIT)];
+
+#define _POOL(name, type, numof, mem) \
+    { name, sizeof(type), CCNL_POOL_BLOCK(type), numof, (uint8_t *)mem, \
+      NULL, 0, 0, 0, 0 }
+
+static _pool_t _pools[] = {
+    _POOL("prefix", struct ccnl_prefix_s, CCNL_POOL_PREFIX, _prefix_mem),
+    _POOL("pkt", struct ccnl_pkt_s, CCNL_POOL_PKT, _pkt_mem),
+    _POOL("content", struct ccnl_content_s, CCNL_POOL_CONTENT, _content_mem),
+    _POOL("pit", struct ccnl_interest_s, CCNL_POOL_PIT, _pit_mem),
+};
+
+#define _POOLS_NUMOF    (sizeof(_pools) / sizeof(_pools[0]))
+
+static ccnl_pool_free_cb_t _free_cb;
+
+/* NULL if no pool serves @p size or all that do are exhausted. Structs of
+ * equal size share their pools. */
+static void *_alloc(size_t size)
+{
+    _pool_t *first = NULL;
+
+    for (unsigned i = 0; i < _POOLS_NUMOF; i++) {
+        _pool_t *p = &_pools[i];
+        _block_t *b = NULL;
+
+        if (p->size != size) {
+            continue;
+        }
+        unsigned state = irq_disable();
+        if (p->free) {
+            b = p->free;
+            p->free = b->next;
+        }
+        else if (p->next < p->numof) {
+            b = (_block_t *)(p->mem + (p->next++ * p->block));
+        }
+        if (b && (++p->used > p->high)) {
+            p->high = p->used;
+        }
+        irq_restore(state);
+        if (b) {
+            return b;
+        }
+        if (!first) {
+            first = p;
+        }
+    }
+    if (first) {
+        unsigned state = irq_disable();
+        first->fails++;
+        irq_restore(state);
+    }
+    return NULL;
+}
+
+static _pool_t *_owner(void *ptr)
+{
+    uint8_t *b = ptr;
+
+    for (unsigned i = 0; i < _POOLS_NUMOF; i++) {
+        _pool_t *p = &_pools[i];
+        if ((b >= p->mem) && (b < p->mem + (p->numof * p->block))) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+void *__wrap_malloc(size_t size)
+{
+    void *ptr = _alloc(size);
+
+    return ptr ? ptr : __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    void *ptr;
+
+    if (size && (nmemb > SIZE_MAX / size)) {
+        return NULL;
+    }
+    ptr = _alloc(nmemb * size);
+    if (!ptr) {
+        return __real_calloc(nmemb, size);
+    }
+    memset(ptr, 0, nmemb * size);
+    return ptr;
+}
+
+void __wrap_free(void *ptr)
+{
+    _pool_t *p;
+
+    if (!ptr) {
+        return;
+    }
+    p = _owner(ptr);
+    if (!p) {
+        __real_free(ptr);
+        return;
+    }
+    if (_free_cb && (p->size == sizeof(struct ccnl_content_s))) {
+        _free_cb(ptr);
+    }
+    unsigned state = irq_disable();
+    ((_block_t *)ptr)->next = p->free;
+    p->free = ptr;
+    p->used--;
+    irq_restore(state);
+}
+
+void ccnl_pool_set_free_cb(ccnl_pool_free_cb_t cb)
+{
+    _free_cb = cb;
+}
+
+bool ccnl_pool_is_content(const void *ptr)
+{
+    _pool_t *p = _owner((void *)ptr);
+
+    return p && (p->size == sizeof(struct ccnl_content_s));
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    _pool_t *p;
+    void *n;
+
+    if (!ptr) {
+        return __wrap_malloc(size);
+    }
+    p = _owner(ptr);
+    if (!p) {
+        return __real_realloc(ptr, size);
+    }
+    if (size <= p->size) {
+        return ptr;
+    }
+    n = __wrap_malloc(size);
+    if (n) {
+        memcpy(n, ptr, p->size);
+        __wrap_free(ptr);
+    }
+    return n;
+}
+
+int ccnl_pool_stats(int argc, char **argv)
+{
+    bool reset = (argc > 1) && !strcmp(argv[1], "reset");
+
+    for (unsigned i = 0; i < _POOLS_NUMOF; i++) {
+        _pool_t *p = &_pools[i];
+
+        if (reset) {
+            unsigned state = irq_disable();
+            p->high = p->used;
+            p->fails = 0;
+            irq_restore(state);
+            continue;
+        }
+        /* POOL;<name>;<object bytes>;<blocks>;<used>;<high-water>;<failed> */
+        printf("POOL;%s;%u;%u;%u;%u;%u\n", p->name, (unsigned)p->size,
+               p->numof, p->used, p->high, p->fails);
+    }
+    return 0;
+}
+
+#endif /* CCNL_POOLS */
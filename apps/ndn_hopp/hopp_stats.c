@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* only linked with -Wl,--wrap=_gnrc_netapi_send_recv, see the Makefile */
+#ifdef HOPP_STATS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "ccn-lite-riot.h"
+#include "net/hopp/hopp.h"
+#include "hopp_stats.h"
+
+#ifndef HOPP_STATS_STACKSIZE
+#define HOPP_STATS_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+#ifndef COMPAS_DODAG_UNDEF
+#define COMPAS_DODAG_UNDEF      (UINT16_MAX)
+#endif
+
+typedef struct {
+    uint8_t type;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t dups;
+} _type_t;
+
+typedef struct {
+    uint32_t hash;
+    size_t len;
+    uint32_t at;
+} _seen_t;
+
+typedef struct {
+    uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t len;
+} _neigh_t;
+
+static struct {
+    uint32_t frames;        /* all CCN frames, control or not */
+    uint32_t ctrl;
+    uint32_t ctrl_bytes;
+    uint32_t dups;
+    uint32_t untracked;     /* control frames of types beyond the table */
+    uint32_t sent;          /* control frames handed to the interface */
+    uint32_t sent_bytes;
+} _stats;
+
+static _type_t _types[HOPP_STATS_TYPES_NUMOF];
+static unsigned _types_num;
+static _seen_t _seen[HOPP_STATS_DUP_NUMOF];
+static unsigned _seen_next;
+static _neigh_t _neighs[HOPP_STATS_NEIGH_NUMOF];
+static unsigned _neighs_num;
+
+static uint16_t _rank = COMPAS_DODAG_UNDEF;
+static uint32_t _joined_ms;
+static uint32_t _changed_ms;
+static uint32_t _changes;
+
+static char _stack[HOPP_STATS_STACKSIZE];
+static msg_t _mbox[HOPP_STATS_MBOX_SIZE];
+static gnrc_netreg_entry_t _entry;
+
+static uint32_t _now_ms(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_MS);
+}
+
+/* FNV-1a */
+static uint32_t _hash(const uint8_t *data, size_t len)
+{
+    uint32_t h = 2166136261U;
+
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619U;
+    }
+    return h;
+}
+
+static void _rank_poll(void)
+{
+    if (dodag.rank == _rank) {
+        return;
+    }
+    if (_rank == COMPAS_DODAG_UNDEF) {
+        _joined_ms = _now_ms();
+    }
+    else {
+        _changes++;
+    }
+    _changed_ms = _now_ms();
+    _rank = dodag.rank;
+}
+
+static void _neigh(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *nh = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    gnrc_netif_hdr_t *hdr;
+    uint8_t *addr;
+
+    if (!nh) {
+        return;
+    }
+    hdr = nh->data;
+    addr = gnrc_netif_hdr_get_src_addr(hdr);
+    if (hdr->src_l2addr_len > GNRC_NETIF_L2ADDR_MAXLEN) {
+        return;
+    }
+    for (unsigned i = 0; i < _neighs_num; i++) {
+        if ((_neighs[i].len == hdr->src_l2addr_len) &&
+            !memcmp(_neighs[i].addr, addr, hdr->src_l2addr_len)) {
+            return;
+        }
+    }
+    if (_neighs_num < HOPP_STATS_NEIGH_NUMOF) {
+        memcpy(_neighs[_neighs_num].addr, addr, hdr->src_l2addr_len);
+        _neighs[_neighs_num].len = hdr->src_l2addr_len;
+        _neighs_num++;
+    }
+}
+
+static bool _dup(const uint8_t *data, size_t len)
+{
+    uint32_t h = _hash(data, len);
+    uint32_t now = xtimer_now_usec();
+
+    for (unsigned i = 0; i < HOPP_STATS_DUP_NUMOF; i++) {
+        _seen_t *s = &_seen[i];
+
+        if (s->len && (s->hash == h) && (s->len == len) &&
+            ((now - s->at) < HOPP_STATS_DUP_WINDOW)) {
+            s->at = now;
+            return true;
+        }
+    }
+    _seen[_seen_next].hash = h;
+    _seen[_seen_next].len = len;
+    _seen[_seen_next].at = now;
+    _seen_next = (_seen_next + 1) % HOPP_STATS_DUP_NUMOF;
+    return false;
+}
+
+static void _ctrl(const uint8_t *data, size_t len)
+{
+    _type_t *t = NULL;
+    bool dup = _dup(data, len);
+
+    _stats.ctrl++;
+    _stats.ctrl_bytes += len;
+    if (dup) {
+        _stats.dups++;
+    }
+    for (unsigned i = 0; i < _types_num; i++) {
+        if (_types[i].type == data[0]) {
+            t = &_types[i];
+            break;
+        }
+    }
+    if (!t) {
+        if (_types_num == HOPP_STATS_TYPES_NUMOF) {
+            _stats.untracked++;
+            return;
+        }
+        t = &_types[_types_num++];
+        t->type = data[0];
+    }
+    t->frames++;
+    t->bytes += len;
+    if (dup) {
+        t->dups++;
+    }
+}
+
+static bool _is_ctrl(const uint8_t *data, size_t len)
+{
+    /* NDN packets start with their type, HoPP's use types of their own */
+    return (len > 0) && (data[0] != NDN_TLV_Interest) &&
+           (data[0] != NDN_TLV_Data);
+}
+
+int __real__gnrc_netapi_send_recv(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
+                                  uint16_t type);
+
+/* gnrc_netapi_send() is inline, so the relay's and HoPP's sends both end
+ * up here, in their own threads */
+int __wrap__gnrc_netapi_send_recv(kernel_pid_t pid, gnrc_pktsnip_t *pkt,
+                                  uint16_t type)
+{
+    if (type == GNRC_NETAPI_MSG_TYPE_SND) {
+        gnrc_pktsnip_t *p = pkt;
+
+        /* the payload follows the interface header */
+        while (p && (p->type == GNRC_NETTYPE_NETIF)) {
+            p = p->next;
+        }
+        if (p && _is_ctrl(p->data, p->size)) {
+            _stats.sent++;
+            _stats.sent_bytes += gnrc_pkt_len(p);
+        }
+    }
+    return __real__gnrc_netapi_send_recv(pid, pkt, type);
+}
+
+static void *_loop(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_mbox, HOPP_STATS_MBOX_SIZE);
+
+    while (1) {
+        msg_t m;
+        gnrc_pktsnip_t *pkt;
+
+        msg_receive(&m);
+        if (m.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        pkt = m.content.ptr;
+        _stats.frames++;
+        _neigh(pkt);
+        if (_is_ctrl(pkt->data, pkt->size)) {
+            _ctrl(pkt->data, pkt->size);
+        }
+        gnrc_pktbuf_release(pkt);
+        _rank_poll();
+    }
+    return NULL;
+}
+
+int hopp_stats_init(void)
+{
+    kernel_pid_t pid = thread_create(_stack, sizeof(_stack), HOPP_STATS_PRIO,
+                                     THREAD_CREATE_STACKTEST, _loop, NULL,
+                                     "hopp_stats");
+
+    if (pid <= KERNEL_PID_UNDEF) {
+        puts("hopp_stats: cannot start thread");
+        return -1;
+    }
+    gnrc_netreg_entry_init_pid(&_entry, GNRC_NETREG_DEMUX_CTX_ALL, pid);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN, &_entry);
+    return 0;
+}
+
+int hopp_stats(int argc, char **argv)
+{
+    _rank_poll();
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        memset(_seen, 0, sizeof(_seen));
+        _types_num = 0;
+        _neighs_num = 0;
+        _changes = 0;
+        return 0;
+    }
+    /* HOPP;<joined ms>;<rank>;<rank changes>;<last change ms>;<neighbours>;
+     *      <frames>;<control frames>;<control bytes>;<duplicates>;
+     *      <sent control frames>;<sent control bytes> */
+    printf("HOPP;%lu;%u;%lu;%lu;%u;%lu;%lu;%lu;%lu;%lu;%lu\n",
+           (unsigned long)_joined_ms, (unsigned)_rank,
+           (unsigned long)_changes, (unsigned long)_changed_ms, _neighs_num,
+           (unsigned long)_stats.frames, (unsigned long)_stats.ctrl,
+           (unsigned long)_stats.ctrl_bytes, (unsigned long)_stats.dups,
+           (unsigned long)_stats.sent, (unsigned long)_stats.sent_bytes);
+    for (unsigned i = 0; i < _types_num; i++) {
+        /* HOPPMSG;<type>;<frames>;<bytes>;<duplicates> */
+        printf("HOPPMSG;0x%02x;%lu;%lu;%lu\n", _types[i].type,
+               (unsigned long)_types[i].frames, (unsigned long)_types[i].bytes,
+               (unsigned long)_types[i].dups);
+    }
+    if (_stats.untracked) {
+        printf("HOPPMSG;other;%lu;;\n", (unsigned long)_stats.untracked);
+    }
+    return 0;
+}
+
+#endif /* HOPP_STATS */
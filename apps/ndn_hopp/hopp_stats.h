@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       HoPP convergence and control overhead
+ *
+ * A thread registers for received CCN frames next to the relay and gets a
+ * copy of each. Frames that are neither Interests nor Data are HoPP's
+ * control messages; they are counted per message type with their bytes,
+ * and a message heard again with the same content within
+ * HOPP_STATS_DUP_WINDOW counts as a duplicate, the redundancy Trickle
+ * suppresses on. The senders of all frames give the neighbour count.
+ *
+ * The control messages the node sends itself, its own share of the
+ * overhead, are counted with their bytes where GNRC hands frames to the
+ * interface, see the HOPP_STATS block in the Makefile.
+ *
+ * Convergence is taken from the DODAG rank: when the node first joined and
+ * when its rank last changed, counted from boot.
+ *
+ * @}
+ */
+
+#ifndef HOPP_STATS_H
+#define HOPP_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* distinct senders tracked */
+#ifndef HOPP_STATS_NEIGH_NUMOF
+#define HOPP_STATS_NEIGH_NUMOF  (32)
+#endif
+
+/* control message types tracked */
+#ifndef HOPP_STATS_TYPES_NUMOF
+#define HOPP_STATS_TYPES_NUMOF  (8)
+#endif
+
+/* control messages remembered to recognise duplicates */
+#ifndef HOPP_STATS_DUP_NUMOF
+#define HOPP_STATS_DUP_NUMOF    (16)
+#endif
+
+#ifndef HOPP_STATS_DUP_WINDOW
+#define HOPP_STATS_DUP_WINDOW   (10U * US_PER_SEC)
+#endif
+
+#ifndef HOPP_STATS_PRIO
+#define HOPP_STATS_PRIO         (CCNL_THREAD_PRIORITY + 1)
+#endif
+
+#ifndef HOPP_STATS_MBOX_SIZE
+#define HOPP_STATS_MBOX_SIZE    (16)
+#endif
+
+/**
+ * @brief   Start counting received frames
+ *
+ * @return  0 on success, -1 if the thread cannot be started
+ */
+int hopp_stats_init(void);
+
+/**
+ * @brief   Shell command printing convergence, neighbours and control
+ *          messages per type, "reset" clears the counters
+ */
+int hopp_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOPP_STATS_H */
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* netstats_l2 is only pulled in with LINK_LQ, see the Makefile */
+#ifdef LINK_LQ
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/netopt.h"
+#include "net/netstats.h"
+
+#include "ccn-lite-riot.h"
+#include "net/hopp/hopp.h"
+#include "link_lq.h"
+
+#ifndef LINK_LQ_STACKSIZE
+#define LINK_LQ_STACKSIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+#ifndef COMPAS_DODAG_UNDEF
+#define COMPAS_DODAG_UNDEF      (UINT16_MAX)
+#endif
+
+typedef struct {
+    uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t len;
+    bool bad;
+    uint32_t lqi;           /* scaled by 2^LINK_LQ_SHIFT */
+    int32_t rssi;           /* scaled by 2^LINK_LQ_SHIFT */
+    uint32_t frames;
+    uint32_t flaps;
+    uint32_t dropped;
+} _neigh_t;
+
+static struct {
+    uint32_t bcast;         /* broadcast HoPP messages received */
+    uint32_t dropped;
+    uint32_t changes;       /* rank changes after joining */
+} _stats;
+
+static _neigh_t _neighs[LINK_LQ_NEIGH_NUMOF];
+static unsigned _neighs_num;
+static uint16_t _rank = COMPAS_DODAG_UNDEF;
+
+static char _stack[LINK_LQ_STACKSIZE];
+static msg_t _mbox[LINK_LQ_MBOX_SIZE];
+static gnrc_netreg_entry_t _entry;
+static kernel_pid_t _netif = KERNEL_PID_UNDEF;
+static netstats_t _base;
+
+static netstats_t *_netstats(void)
+{
+    netstats_t *stats = NULL;
+
+    if ((_netif == KERNEL_PID_UNDEF) ||
+        (gnrc_netapi_get(_netif, NETOPT_STATS, NETSTATS_LAYER2, &stats,
+                         sizeof(&stats)) < 0)) {
+        return NULL;
+    }
+    return stats;
+}
+
+static void _rank_poll(void)
+{
+    if (dodag.rank == _rank) {
+        return;
+    }
+    if (_rank != COMPAS_DODAG_UNDEF) {
+        _stats.changes++;
+    }
+    _rank = dodag.rank;
+}
+
+static _neigh_t *_neigh(const uint8_t *addr, uint8_t len)
+{
+    _neigh_t *n;
+
+    if (len > GNRC_NETIF_L2ADDR_MAXLEN) {
+        return NULL;
+    }
+    for (unsigned i = 0; i < _neighs_num; i++) {
+        if ((_neighs[i].len == len) && !memcmp(_neighs[i].addr, addr, len)) {
+            return &_neighs[i];
+        }
+    }
+    if (_neighs_num == LINK_LQ_NEIGH_NUMOF) {
+        return NULL;
+    }
+    n = &_neighs[_neighs_num++];
+    memset(n, 0, sizeof(*n));
+    memcpy(n->addr, addr, len);
+    n->len = len;
+    return n;
+}
+
+static void _sample(_neigh_t *n, gnrc_netif_hdr_t *hdr)
+{
+    if (!n->frames++) {
+        n->lqi = (uint32_t)hdr->lqi << LINK_LQ_SHIFT;
+        n->rssi = (int32_t)hdr->rssi * (1 << LINK_LQ_SHIFT);
+    }
+    else {
+        n->lqi += hdr->lqi - (n->lqi >> LINK_LQ_SHIFT);
+        n->rssi += hdr->rssi - (n->rssi / (1 << LINK_LQ_SHIFT));
+    }
+    if (n->frames < LINK_LQ_MIN_FRAMES) {
+        return;
+    }
+    if (!n->bad && ((n->lqi >> LINK_LQ_SHIFT) < LINK_LQ_LOW)) {
+        n->bad = true;
+        n->flaps++;
+    }
+    else if (n->bad && ((n->lqi >> LINK_LQ_SHIFT) > LINK_LQ_HIGH)) {
+        n->bad = false;
+        n->flaps++;
+    }
+}
+
+static bool _is_parent(const _neigh_t *n)
+{
+    return (_rank != COMPAS_DODAG_UNDEF) &&
+           (dodag.parent.face.face_addr_len == n->len) &&
+           !memcmp(dodag.parent.face.face_addr, n->addr, n->len);
+}
+
+static bool _all_bad(void)
+{
+    for (unsigned i = 0; i < _neighs_num; i++) {
+        if (!_neighs[i].bad) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* true if the frame is a PAM over a bad link and must not reach HoPP */
+static bool _drop(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *nh = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    gnrc_netif_hdr_t *hdr;
+    _neigh_t *n;
+    uint8_t typ;
+
+    _rank_poll();
+    if (!nh || !pkt->size) {
+        return false;
+    }
+    hdr = nh->data;
+    n = _neigh(gnrc_netif_hdr_get_src_addr(hdr), hdr->src_l2addr_len);
+    if (n) {
+        _sample(n, hdr);
+    }
+    /* NDN packets start with their type, HoPP's use types of their own */
+    typ = ((uint8_t *)pkt->data)[0];
+    if ((typ == NDN_TLV_Interest) || (typ == NDN_TLV_Data) ||
+        !(hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                        GNRC_NETIF_HDR_FLAGS_MULTICAST))) {
+        return false;
+    }
+    _stats.bcast++;
+    /* HoPP only leaves its parent for a better rank or on its timeout, so
+     * keep the parent's PAMs rather than wait for that timeout; if no good
+     * link is left, any parent is better than none */
+    if (!n || !n->bad || _is_parent(n) || _all_bad()) {
+        return false;
+    }
+    n->dropped++;
+    _stats.dropped++;
+    return true;
+}
+
+static void *_loop(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_mbox, LINK_LQ_MBOX_SIZE);
+
+    while (1) {
+        msg_t m;
+
+        msg_receive(&m);
+        if ((m.type == GNRC_NETAPI_MSG_TYPE_RCV) && _drop(m.content.ptr)) {
+            gnrc_pktbuf_release(m.content.ptr);
+            continue;
+        }
+        msg_send(&m, _ccnl_event_loop_pid);
+    }
+    return NULL;
+}
+
+int link_lq_init(kernel_pid_t netif)
+{
+    gnrc_netreg_entry_t *relay = gnrc_netreg_lookup(GNRC_NETTYPE_CCN,
+                                                    GNRC_NETREG_DEMUX_CTX_ALL);
+    netstats_t *stats;
+    kernel_pid_t pid;
+
+    while (relay && (relay->target.pid != _ccnl_event_loop_pid)) {
+        relay = gnrc_netreg_getnext(relay);
+    }
+    if (!relay) {
+        puts("link_lq: relay not registered");
+        return -1;
+    }
+    _netif = netif;
+    stats = _netstats();
+    if (stats) {
+        _base = *stats;
+    }
+    pid = thread_create(_stack, sizeof(_stack), LINK_LQ_PRIO,
+                        THREAD_CREATE_STACKTEST, _loop, NULL, "link_lq");
+    if (pid <= KERNEL_PID_UNDEF) {
+        puts("link_lq: cannot start thread");
+        return -1;
+    }
+    gnrc_netreg_entry_init_pid(&_entry, GNRC_NETREG_DEMUX_CTX_ALL, pid);
+    gnrc_netreg_unregister(GNRC_NETTYPE_CCN, relay);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN, &_entry);
+    return 0;
+}
+
+int link_lq_stats(int argc, char **argv)
+{
+    netstats_t *stats = _netstats();
+    uint32_t ok = 0, failed = 0;
+    unsigned bad = 0;
+
+    _rank_poll();
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        for (unsigned i = 0; i < _neighs_num; i++) {
+            _neighs[i].flaps = 0;
+            _neighs[i].dropped = 0;
+        }
+        if (stats) {
+            _base = *stats;
+        }
+        return 0;
+    }
+    if (stats) {
+        ok = stats->tx_success - _base.tx_success;
+        failed = stats->tx_failed - _base.tx_failed;
+    }
+    for (unsigned i = 0; i < _neighs_num; i++) {
+        bad += _neighs[i].bad;
+    }
+    /* LINK;<rank>;<rank changes>;<tx ok>;<tx failed>;<delivery %>;
+     *      <HoPP broadcasts>;<dropped>;<neighbours>;<bad links> */
+    printf("LINK;%u;%lu;%lu;%lu;%lu;%lu;%lu;%u;%u\n", (unsigned)_rank,
+           (unsigned long)_stats.changes, (unsigned long)ok,
+           (unsigned long)failed,
+           (unsigned long)((ok + failed) ?
+                           (100 * (uint64_t)ok) / (ok + failed) : 0),
+           (unsigned long)_stats.bcast, (unsigned long)_stats.dropped,
+           _neighs_num, bad);
+    for (unsigned i = 0; i < _neighs_num; i++) {
+        _neigh_t *n = &_neighs[i];
+        char addr[GNRC_NETIF_L2ADDR_MAXLEN * 3];
+
+        gnrc_netif_addr_to_str(n->addr, n->len, addr);
+        /* LINKNB;<address>;<frames>;<LQI>;<RSSI>;<good|bad>;<flaps>;
+         *        <dropped> */
+        printf("LINKNB;%s;%lu;%lu;%ld;%s;%lu;%lu\n", addr,
+               (unsigned long)n->frames,
+               (unsigned long)(n->lqi >> LINK_LQ_SHIFT),
+               (long)(n->rssi / (1 << LINK_LQ_SHIFT)),
+               n->bad ? "bad" : "good", (unsigned long)n->flaps,
+               (unsigned long)n->dropped);
+    }
+    return 0;
+}
+
+#endif /* LINK_LQ */
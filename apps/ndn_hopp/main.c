@@ -8,6 +8,7 @@
 
 
 #include <stdio.h>
+#include <string.h>
 
 #ifdef MODULE_TLSF
 #include "tlsf-malloc.h"
@@ -23,13 +24,52 @@
 #include "ccnl-pkt-builder.h"
 #include "net/hopp/hopp.h"
 
+#ifdef CS_POLICY
+#include "cs_policy.h"
+#endif
+#ifdef CCNL_POOLS
+#include "ccnl_pool.h"
+#endif
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef I3_TLV
+#include "i3_tlv.h"
+#endif
+#ifdef RELAY_Q
+#include "relay_q.h"
+#endif
+#ifdef LINK_LQ
+#include "link_lq.h"
+#endif
+#ifdef L2_STATS
+#include "l2_stats.h"
+#endif
+#ifdef BATCH
+#include "batch.h"
+#endif
+#ifdef HOPP_STATS
+#include "hopp_stats.h"
+#endif
+#ifdef PUB_Q
+#include "pub_q.h"
+#endif
+#ifdef PUB_ZC
+#include "pub_zc.h"
+#endif
+
 /* main thread's message queue */
 #define MAIN_QUEUE_SIZE     (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
 #ifdef MODULE_TLSF
 /* 10kB buffer for the heap should be enough for everyone */
+#ifdef CCNL_POOLS
+/* the pools take their memory from the heap */
+#define TLSF_BUFFER     ((40 * 1024 - CCNL_POOL_BYTES) / sizeof(uint32_t))
+#else
 #define TLSF_BUFFER     ((40 * 1024) / sizeof(uint32_t))
+#endif
 static uint32_t _tlsf_heap[TLSF_BUFFER];
 #endif
 
@@ -81,13 +121,33 @@ static char _consumer_stack[CONSUMER_STACKSIZE];
 /* state for running pktcnt module */
 uint8_t pktcnt_running = 0;
 
+#ifdef PUB_ZC
+/* the reading stays in place, only the headers around it are rewritten */
+static unsigned char _content_buf[PUB_ZC_BUF_SIZE(sizeof(I3_DATA) - 1)];
+#endif
+
 void *_consumer_event_loop(void *arg)
 {
     (void)arg;
     /* periodically request content items */
+#ifdef BATCH
+    batch_init(PREFIX, my_hwaddr_str, "0x12a77af232");
+    for (unsigned i=0; i<NUM_REQUESTS_NODE; i++) {
+        batch_sleep(REQ_DELAY);
+        batch_add(i, 3000);
+    }
+    batch_flush();
+#else
     static char name[80];
+#ifdef PUB_ZC
+    memcpy(&_content_buf[PUB_ZC_HEADROOM], I3_DATA, sizeof(I3_DATA) - 1);
+#endif
     for (unsigned i=0; i<NUM_REQUESTS_NODE; i++) {
+#ifdef PUB_Q
+        pub_q_sleep(REQ_DELAY);
+#else
         xtimer_usleep(REQ_DELAY);
+#endif
         unsigned name_len = snprintf(name, 80, "/i3/%s/gasval/%04d", my_hwaddr_str, i);
 #ifdef MODULE_PKTCNT_FAST
         uint64_t now = xtimer_now_usec64();
@@ -95,8 +155,15 @@ void *_consumer_event_loop(void *arg)
             (unsigned long)div_u64_by_1000000(now),
             (unsigned long)now % US_PER_SEC);
 #endif
+#if defined(PUB_ZC)
+        pub_zc_publish(name, name_len, _content_buf, sizeof(I3_DATA) - 1);
+#elif defined(PUB_Q)
+        pub_q_publish(name, name_len, (unsigned char*)i3_data, 32);
+#else
         hopp_publish_content(name, name_len, (unsigned char*)i3_data, 32);
+#endif
     }
+#endif
     return 0;
 }
 
@@ -156,9 +223,61 @@ static int _pktcnt_start(int argc, char **argv) {
 }
 #endif
 
+#if defined(CS_POLICY) || defined(CS_INDEX)
+/* local producer that only samples the content store and never answers,
+ * except with cached content with CS_INDEX */
+static int _sample_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                            struct ccnl_pkt_s *pkt)
+{
+    (void)from;
+#ifdef CS_POLICY
+    cs_policy_sample(relay, pkt);
+#endif
+#ifdef CS_INDEX
+    return cs_idx_serve(relay, from, pkt);
+#else
+    return 0;
+#endif
+}
+#endif
+
 static const shell_command_t shell_commands[] = {
     { "hr", "start HoPP root", _root },
     { "req_start", "start periodic content requests", _req_start },
+#ifdef CS_POLICY
+    { "cs", "print content store counters, \"cs reset\" clears them", cs_policy_stats },
+#endif
+#ifdef CCNL_POOLS
+    { "pools", "print CCN-lite pool use, \"pools reset\" clears it", ccnl_pool_stats },
+#endif
+#ifdef CS_INDEX
+    { "cs_bench", "benchmark CS lookups, list vs. hash index", cs_idx_bench },
+#endif
+#ifdef I3_TLV
+    { "tlv", "print packets decoded on the i3 fast path, \"tlv reset\" clears them", i3_tlv_stats },
+    { "tlv_bench", "benchmark NDN-TLV decoding, generic vs. i3 fast path", i3_tlv_bench },
+#endif
+#ifdef RELAY_Q
+    { "relayq", "print received frames queued and dropped per class, \"relayq reset\" clears them", relay_q_stats },
+#endif
+#ifdef BATCH
+    { "batch", "print readings per publication and hold times, \"batch reset\" clears them", batch_stats },
+#endif
+#ifdef HOPP_STATS
+    { "hopp", "print HoPP convergence, neighbours and control messages, \"hopp reset\" clears them", hopp_stats },
+#endif
+#ifdef PUB_Q
+    { "pubq", "print publications HoPP refused and the backlog, \"pubq reset\" clears them", pub_q_stats },
+#endif
+#ifdef PUB_ZC
+    { "pubzc", "print in-place publications and failures, \"pubzc reset\" clears them", pub_zc_stats },
+#endif
+#ifdef LINK_LQ
+    { "link", "print rank changes, delivery ratio and link quality per neighbour, \"link reset\" clears them", link_lq_stats },
+#endif
+#ifdef L2_STATS
+    { "l2", "print link-layer unicast and broadcast frames, \"l2 reset\" clears them", l2_stats },
+#endif
 #ifdef MODULE_PKTCNT_FAST
     { "pktcnt_p", "print variables of pktcnt_fast module", _pktcnt_p },
 #else
@@ -180,16 +299,44 @@ int main(void)
     ccnl_core_init();
 
     ccnl_start();
+#ifdef CS_POLICY
+    cs_policy_init();
+#endif
+#ifdef CS_INDEX
+    cs_idx_attach();
+#endif
 
     /* get the default interface */
     netif = gnrc_netif_iter(NULL);
 
     gnrc_netapi_set(netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
 
-    /* set the relay's PID, configure the interface to use CCN nettype */
+    /* set the relay's PID, configure the interface to use CCN nettype.
+     * CCN-lite copies every received frame into a ccnl_buf_s, whose bytes
+     * are inline, and every packet it sends into a new snip. Both copies
+     * are inside the package's RIOT adaptation, wrapping ccnl_ll_TX() only
+     * sees the finished buffer, so the app cannot remove them. */
     if (ccnl_open_netif(netif->pid, GNRC_NETTYPE_CCN) < 0) {
         return -1;
     }
+#ifdef L2_STATS
+    l2_stats_init(netif->pid);
+#endif
+#ifdef RELAY_Q
+    if (relay_q_init() < 0) {
+        return -1;
+    }
+#endif
+#ifdef HOPP_STATS
+    if (hopp_stats_init() < 0) {
+        return -1;
+    }
+#endif
+#ifdef LINK_LQ
+    if (link_lq_init(netif->pid) < 0) {
+        return -1;
+    }
+#endif
 
 #ifdef MODULE_GNRC_PKTDUMP
     gnrc_netreg_entry_t dump = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
@@ -197,6 +344,10 @@ int main(void)
     gnrc_netreg_register(GNRC_NETTYPE_CCN_CHUNK, &dump);
 #endif
 
+#if defined(CS_POLICY) || defined(CS_INDEX)
+    ccnl_set_local_producer(_sample_producer);
+#endif
+
     /* save hw address globally */
 #ifdef BOARD_NATIVE
     gnrc_netapi_get(netif->pid, NETOPT_ADDRESS, 0, my_hwaddr, sizeof(my_hwaddr));
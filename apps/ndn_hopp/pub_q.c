@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "net/hopp/hopp.h"
+#include "pub_q.h"
+
+typedef struct _entry {
+    struct _entry *next;
+    uint32_t since;
+    size_t name_len;
+    size_t len;
+    char data[];            /* name, then content */
+} _entry_t;
+
+static struct {
+    uint32_t published;     /* at the first attempt */
+    uint32_t queued;        /* refused, or behind the backlog */
+    uint32_t retried;       /* published from the backlog */
+    uint32_t dropped;
+    uint64_t waited;        /* us, summed over all retried publications */
+    uint32_t waited_max;
+    unsigned pending_high;
+    size_t bytes_high;
+} _stats;
+
+static _entry_t *_head;
+static _entry_t *_tail;
+static unsigned _pending;
+static size_t _bytes;
+
+static void _retry(void)
+{
+    while (_head) {
+        _entry_t *e = _head;
+        /* without content HoPP only announces the name */
+        unsigned char *content = e->len ? (unsigned char *)&e->data[e->name_len]
+                                        : NULL;
+        uint32_t waited;
+
+        if (!hopp_publish_content(e->data, e->name_len, content, e->len)) {
+            return;
+        }
+        waited = xtimer_now_usec() - e->since;
+        _stats.retried++;
+        _stats.waited += waited;
+        if (waited > _stats.waited_max) {
+            _stats.waited_max = waited;
+        }
+        _head = e->next;
+        if (!_head) {
+            _tail = NULL;
+        }
+        _pending--;
+        _bytes -= sizeof(*e) + e->name_len + e->len;
+        free(e);
+    }
+}
+
+static int _queue(const char *name, size_t name_len,
+                  const unsigned char *content, size_t len)
+{
+    size_t size = sizeof(_entry_t) + name_len + len;
+    _entry_t *e;
+
+    if ((_bytes + size > PUB_Q_BYTES) || !(e = malloc(size))) {
+        _stats.dropped++;
+        return -1;
+    }
+    e->next = NULL;
+    e->since = xtimer_now_usec();
+    e->name_len = name_len;
+    e->len = len;
+    memcpy(e->data, name, name_len);
+    if (len) {
+        memcpy(&e->data[name_len], content, len);
+    }
+    if (_tail) {
+        _tail->next = e;
+    }
+    else {
+        _head = e;
+    }
+    _tail = e;
+    _stats.queued++;
+    if (++_pending > _stats.pending_high) {
+        _stats.pending_high = _pending;
+    }
+    _bytes += size;
+    if (_bytes > _stats.bytes_high) {
+        _stats.bytes_high = _bytes;
+    }
+    return 0;
+}
+
+int pub_q_publish(const char *name, size_t name_len,
+                  const unsigned char *content, size_t len)
+{
+    _retry();
+    /* keep the order, nothing overtakes the backlog */
+    if (!_head && hopp_publish_content(name, name_len,
+                                       (unsigned char *)content, len)) {
+        _stats.published++;
+        return 0;
+    }
+    return _queue(name, name_len, content, len);
+}
+
+unsigned pub_q_pending(void)
+{
+    _retry();
+    return _pending;
+}
+
+void pub_q_sleep(uint32_t usec)
+{
+    uint32_t until = xtimer_now_usec() + usec;
+
+    while (_head &&
+           ((int32_t)(until - xtimer_now_usec()) > (int32_t)PUB_Q_RETRY)) {
+        xtimer_usleep(PUB_Q_RETRY);
+        _retry();
+    }
+    if ((int32_t)(until - xtimer_now_usec()) > 0) {
+        xtimer_usleep(until - xtimer_now_usec());
+    }
+}
+
+int pub_q_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        _stats.pending_high = _pending;
+        _stats.bytes_high = _bytes;
+        return 0;
+    }
+    /* PUBQ;<published>;<queued>;<retried>;<dropped>;<pending>;
+     *      <pending high>;<bytes>;<bytes high>;<mean wait ms>;<max wait ms> */
+    printf("PUBQ;%lu;%lu;%lu;%lu;%u;%u;%u;%u;%lu;%lu\n",
+           (unsigned long)_stats.published, (unsigned long)_stats.queued,
+           (unsigned long)_stats.retried, (unsigned long)_stats.dropped,
+           _pending, _stats.pending_high, (unsigned)_bytes,
+           (unsigned)_stats.bytes_high,
+           (unsigned long)(_stats.retried ?
+                           (_stats.waited / _stats.retried) / US_PER_MS : 0),
+           (unsigned long)(_stats.waited_max / US_PER_MS));
+    return 0;
+}
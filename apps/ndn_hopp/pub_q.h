@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Backlog for publications HoPP refuses
+ *
+ * hopp_publish_content() fails once compas' NAM cache is full, and the
+ * reading is lost. Publications go through this backlog instead: a refused
+ * one is copied to the heap and retried, in order, before every further
+ * publication and every PUB_Q_RETRY while the consumer sleeps. The backlog
+ * takes at most PUB_Q_BYTES of the TLSF heap; only beyond that a
+ * publication is dropped, and counted.
+ *
+ * @}
+ */
+
+#ifndef PUB_Q_H
+#define PUB_Q_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* heap the backlog may take, including its bookkeeping */
+#ifndef PUB_Q_BYTES
+#define PUB_Q_BYTES             (2048)
+#endif
+
+/* interval between retries of the backlog */
+#ifndef PUB_Q_RETRY
+#define PUB_Q_RETRY             (2U * US_PER_SEC)
+#endif
+
+/**
+ * @brief   Publish @p content under @p name, queue it if HoPP refuses
+ *
+ * With @p content NULL and @p len 0 only the name is announced.
+ *
+ * @return  0 if published or queued, -1 if dropped
+ */
+int pub_q_publish(const char *name, size_t name_len,
+                  const unsigned char *content, size_t len);
+
+/**
+ * @brief   Retry the backlog
+ *
+ * @return  publications still pending, nothing may be published before
+ *          them
+ */
+unsigned pub_q_pending(void);
+
+/**
+ * @brief   Sleep for @p usec, retrying the backlog meanwhile
+ */
+void pub_q_sleep(uint32_t usec);
+
+/**
+ * @brief   Shell command printing publications, refusals and the backlog,
+ *          "reset" clears the counters
+ */
+int pub_q_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUB_Q_H */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+
+#include "ccn-lite-riot.h"
+#include "net/hopp/hopp.h"
+#ifdef PUB_Q
+#include "pub_q.h"
+#endif
+#include "pub_zc.h"
+
+static struct {
+    uint32_t published;
+    uint32_t failed;        /* packet not built or not handed to the relay */
+    uint32_t queued;        /* refused by HoPP, content copied to pub_q */
+    uint32_t refused;       /* name neither announced nor queued */
+    uint32_t bytes;         /* content the encoder did not copy */
+} _stats;
+
+/* type and length, types are below 253 */
+static int _tl_size(size_t len)
+{
+    return (len < 253) ? 2 : 4;
+}
+
+/* length of the Name TLV's value, -1 without components */
+static int _name_size(const char *name, size_t name_len)
+{
+    int size = 0, comps = 0;
+    size_t i = 0;
+
+    while (i < name_len) {
+        size_t start;
+
+        while ((i < name_len) && (name[i] == '/')) {
+            i++;
+        }
+        start = i;
+        while ((i < name_len) && (name[i] != '/')) {
+            i++;
+        }
+        if (i > start) {
+            size += _tl_size(i - start) + (i - start);
+            comps++;
+        }
+    }
+    return comps ? size : -1;
+}
+
+/* components last to first, in front of *@p offs */
+static int _prepend_name(const char *name, size_t name_len, int size,
+                         int *offs, unsigned char *buf)
+{
+    size_t i = name_len;
+
+    while (i > 0) {
+        size_t end;
+
+        while ((i > 0) && (name[i - 1] == '/')) {
+            i--;
+        }
+        end = i;
+        while ((i > 0) && (name[i - 1] != '/')) {
+            i--;
+        }
+        if ((end > i) &&
+            (ccnl_ndntlv_prependBlob(NDN_TLV_NameComponent,
+                                     (unsigned char *)&name[i], end - i,
+                                     offs, buf) < 0)) {
+            return -1;
+        }
+    }
+    return ccnl_ndntlv_prependTL(NDN_TLV_Name, size, offs, buf);
+}
+
+/* same packet as ccnl_ndntlv_prependContent() without a FinalBlockId, i.e.
+ * with an empty MetaInfo as I3_TLV's fast path expects it, but around the
+ * content in place, the packet starts at *@p offs */
+static int _encode(const char *name, size_t name_len, unsigned char *buf,
+                   size_t len, int *offs)
+{
+    unsigned char sig_type = NDN_SigTypeVal_DigestSha256;
+    int end = PUB_ZC_BUF_SIZE(len);
+    int name_size = _name_size(name, name_len);
+    size_t inner;
+
+    if (name_size < 0) {
+        return -1;
+    }
+    /* Name, MetaInfo, Content and the signature inside the Data */
+    inner = _tl_size(name_size) + name_size + 2 + _tl_size(len) + len +
+            PUB_ZC_TAILROOM;
+    if ((inner - len - PUB_ZC_TAILROOM + _tl_size(inner)) > PUB_ZC_HEADROOM) {
+        return -1;
+    }
+    *offs = end;
+    if ((ccnl_ndntlv_prependTL(NDN_TLV_SignatureValue, 0, offs, buf) < 0) ||
+        (ccnl_ndntlv_prependBlob(NDN_TLV_SignatureType, &sig_type, 1, offs,
+                                 buf) < 0) ||
+        (ccnl_ndntlv_prependTL(NDN_TLV_SignatureInfo, 3, offs, buf) < 0)) {
+        return -1;
+    }
+    /* the content is where the application put it */
+    *offs -= len;
+    if ((ccnl_ndntlv_prependTL(NDN_TLV_Content, len, offs, buf) < 0) ||
+        (ccnl_ndntlv_prependTL(NDN_TLV_MetaInfo, 0, offs, buf) < 0) ||
+        (_prepend_name(name, name_len, name_size, offs, buf) < 0) ||
+        (ccnl_ndntlv_prependTL(NDN_TLV_Data, end - *offs, offs, buf) < 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* decoding makes CCN-lite's copy, the only one */
+static struct ccnl_content_s *_content(const char *name, size_t name_len,
+                                       unsigned char *buf, size_t len)
+{
+    unsigned char *data;
+    int offs, datalen, typ, vallen;
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+
+    if (_encode(name, name_len, buf, len, &offs) < 0) {
+        return NULL;
+    }
+    data = buf + offs;
+    datalen = PUB_ZC_BUF_SIZE(len) - offs;
+    if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &vallen)) {
+        return NULL;
+    }
+    pkt = ccnl_ndntlv_bytes2pkt(typ, buf + offs, &data, &datalen);
+    if (!pkt) {
+        return NULL;
+    }
+    c = ccnl_content_new(&pkt);
+    if (!c) {
+        ccnl_pkt_free(pkt);
+    }
+    return c;
+}
+
+/* HoPP refused the name or must not announce it yet */
+static int _refused(const char *name, size_t name_len, unsigned char *buf,
+                    size_t len)
+{
+#ifdef PUB_Q
+    /* the backlog publishes a copy of the content when it retries, with the
+     * announcement, instead of leaving it to the content store meanwhile */
+    if (pub_q_publish(name, name_len, buf + PUB_ZC_HEADROOM, len) == 0) {
+        _stats.queued++;
+        return 0;
+    }
+#else
+    (void)name;
+    (void)name_len;
+    (void)buf;
+    (void)len;
+#endif
+    _stats.refused++;
+    return -1;
+}
+
+int pub_zc_publish(const char *name, size_t name_len, unsigned char *buf,
+                   size_t len)
+{
+    struct ccnl_content_s *c;
+    msg_t m = { .type = CCNL_MSG_ADD_CS };
+
+#ifdef PUB_Q
+    /* keep the order, nothing overtakes the backlog */
+    if (pub_q_pending()) {
+        return _refused(name, name_len, buf, len);
+    }
+#endif
+    c = _content(name, name_len, buf, len);
+    if (!c) {
+        _stats.failed++;
+        return -1;
+    }
+    /* announce the name only, the content follows before any Interest the
+     * NAM draws can reach the relay */
+    if (!hopp_publish_content(name, name_len, NULL, 0)) {
+        ccnl_content_free(c);
+        return _refused(name, name_len, buf, len);
+    }
+    /* the content store belongs to the relay thread */
+    m.content.ptr = c;
+    if (msg_send(&m, _ccnl_event_loop_pid) < 1) {
+        ccnl_content_free(c);
+        _stats.failed++;
+        return -1;
+    }
+    _stats.published++;
+    _stats.bytes += len;
+    return 0;
+}
+
+int pub_zc_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    /* PUBZC;<published>;<failed>;<queued>;<refused>;<content bytes> */
+    printf("PUBZC;%lu;%lu;%lu;%lu;%lu\n", (unsigned long)_stats.published,
+           (unsigned long)_stats.failed, (unsigned long)_stats.queued,
+           (unsigned long)_stats.refused, (unsigned long)_stats.bytes);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Publish a reading from a buffer the application lends
+ *
+ * hopp_publish_content() copies the content into a scratch buffer of
+ * CCNL_MAX_PACKET_SIZE while encoding it, and the encoded packet again
+ * while decoding it for the content store. Here the application keeps the
+ * content at PUB_ZC_HEADROOM in a buffer of PUB_ZC_BUF_SIZE(len) bytes and
+ * lends the buffer. The Data packet is encoded in place around the
+ * content, so the content itself is never copied by the encoder and there
+ * is no scratch buffer. The only copy left is the one into CCN-lite's own
+ * packet buffer. The content is not touched, so a buffer can be published
+ * again as is.
+ *
+ * The buffer is only borrowed for the call, CCN-lite holds its copy before
+ * pub_zc_publish() returns. This stands in for the requested handover of
+ * the buffer to the stack with a completion callback, which is not
+ * implemented: CCN-lite frees a content store entry's packet with
+ * ccnl_free() and offers no hook to return a buffer, so the copy into its
+ * packet buffer stays.
+ *
+ * HoPP gets the name first, to announce it in a NAM. Only once it accepted
+ * the name does the content reach the content store, through the relay's
+ * CCNL_MSG_ADD_CS, i.e. from the relay thread. A name HoPP refuses leaves
+ * nothing cached. With PUB_Q it goes to the backlog together with a copy
+ * of the content, as does every publication while the backlog is not
+ * empty, and the backlog publishes both when it retries; only these
+ * publications are copied.
+ *
+ * @}
+ */
+
+#ifndef PUB_ZC_H
+#define PUB_ZC_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* room for the Data, Name, MetaInfo and Content headers */
+#ifndef PUB_ZC_HEADROOM
+#define PUB_ZC_HEADROOM         (80)
+#endif
+
+/* SignatureInfo and an empty SignatureValue behind the content */
+#define PUB_ZC_TAILROOM         (7)
+
+/* buffer to lend for @p len bytes of content */
+#define PUB_ZC_BUF_SIZE(len)    (PUB_ZC_HEADROOM + (len) + PUB_ZC_TAILROOM)
+
+/**
+ * @brief   Publish the @p len bytes at PUB_ZC_HEADROOM in @p buf under
+ *          @p name
+ *
+ * @p buf is the application's again when this function returns, on errors
+ * too.
+ *
+ * @param[in] name      URI of the Data, e.g. /i3/<id>/gasval/0001
+ * @param[in] name_len  length of @p name
+ * @param[in] buf       PUB_ZC_BUF_SIZE(@p len) bytes, content in place
+ * @param[in] len       length of the content
+ *
+ * @return  0 if published or queued, -1 if the packet cannot be built or
+ *          HoPP dropped the name
+ */
+int pub_zc_publish(const char *name, size_t name_len, unsigned char *buf,
+                   size_t len);
+
+/**
+ * @brief   Shell command printing publications, failures and the bytes
+ *          not copied, "reset" clears the counters
+ */
+int pub_zc_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUB_ZC_H */
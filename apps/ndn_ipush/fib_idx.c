@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "fib_idx.h"
+
+#define FNV_OFFSET              (2166136261U)
+#define FNV_PRIME               (16777619U)
+
+/* lookups per backend and number of entries in fib_idx_bench() */
+#ifndef FIB_IDX_BENCH_LOOKUPS
+#define FIB_IDX_BENCH_LOOKUPS   (10000U)
+#endif
+#define FIB_IDX_BENCH_NAMES     (64U)
+
+static fib_idx_entry_t *_bucket[FIB_IDX_BUCKETS];
+static fib_idx_entry_t _pool[FIB_IDX_NUMOF];
+
+fib_idx_t fib_idx = {
+    .bucket = _bucket,
+    .mask = FIB_IDX_BUCKETS - 1,
+    .pool = _pool,
+    .numof = FIB_IDX_NUMOF,
+};
+
+/* FNV-1a over the length and bytes of one more component */
+static uint32_t _hash_comp(uint32_t hash, const unsigned char *comp, int len)
+{
+    hash = (hash ^ (uint32_t)len) * FNV_PRIME;
+    for (int i = 0; i < len; i++) {
+        hash = (hash ^ comp[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t _hash(struct ccnl_prefix_s *name, int compcnt)
+{
+    uint32_t hash = FNV_OFFSET;
+
+    for (int i = 0; i < compcnt; i++) {
+        hash = _hash_comp(hash, name->comp[i], name->complen[i]);
+    }
+    return hash;
+}
+
+/* prefix equals the first compcnt components of name */
+static int _equal(struct ccnl_prefix_s *prefix, struct ccnl_prefix_s *name,
+                  int compcnt)
+{
+    if (prefix->compcnt != compcnt) {
+        return 0;
+    }
+    for (int i = compcnt - 1; i >= 0; i--) {
+        if ((prefix->complen[i] != name->complen[i]) ||
+            memcmp(prefix->comp[i], name->comp[i], name->complen[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static struct ccnl_forward_s *_find(fib_idx_t *idx, struct ccnl_prefix_s *name,
+                                    int compcnt, uint32_t hash)
+{
+    for (fib_idx_entry_t *e = idx->bucket[hash & idx->mask]; e; e = e->next) {
+        if ((e->hash == hash) && _equal(e->fwd->prefix, name, compcnt)) {
+            return e->fwd;
+        }
+    }
+    return NULL;
+}
+
+void fib_idx_init(fib_idx_t *idx, fib_idx_entry_t **bucket, unsigned buckets,
+                  fib_idx_entry_t *pool, unsigned numof)
+{
+    memset(bucket, 0, buckets * sizeof(*bucket));
+    idx->bucket = bucket;
+    idx->mask = buckets - 1;
+    idx->pool = pool;
+    idx->numof = numof;
+    idx->used = 0;
+    idx->lens = 0;
+}
+
+int fib_idx_add(fib_idx_t *idx, struct ccnl_forward_s *fwd)
+{
+    int compcnt = fwd->prefix->compcnt;
+    fib_idx_entry_t *e;
+
+    if ((idx->used >= idx->numof) || (compcnt > FIB_IDX_COMPCNT_MAX)) {
+        return -1;
+    }
+    e = &idx->pool[idx->used++];
+    e->fwd = fwd;
+    e->hash = _hash(fwd->prefix, compcnt);
+    e->next = idx->bucket[e->hash & idx->mask];
+    idx->bucket[e->hash & idx->mask] = e;
+    idx->lens |= (1U << compcnt);
+    return 0;
+}
+
+int fib_idx_sync(fib_idx_t *idx, struct ccnl_forward_s *fib)
+{
+    /* ccnl_fib_add_entry() appends, so new entries follow the last indexed */
+    struct ccnl_forward_s *fwd = idx->used ? idx->pool[idx->used - 1].fwd->next
+                                           : fib;
+
+    for (; fwd; fwd = fwd->next) {
+        if (fib_idx_add(idx, fwd) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+struct ccnl_forward_s *fib_idx_find(fib_idx_t *idx, struct ccnl_prefix_s *name,
+                                    int compcnt)
+{
+    if ((compcnt > name->compcnt) || (compcnt > FIB_IDX_COMPCNT_MAX) ||
+        !(idx->lens & (1U << compcnt))) {
+        return NULL;
+    }
+    return _find(idx, name, compcnt, _hash(name, compcnt));
+}
+
+struct ccnl_forward_s *fib_idx_lookup(fib_idx_t *idx, struct ccnl_prefix_s *name)
+{
+    uint32_t hash[FIB_IDX_COMPCNT_MAX + 1];
+    int n = (name->compcnt < FIB_IDX_COMPCNT_MAX) ? name->compcnt
+                                                  : FIB_IDX_COMPCNT_MAX;
+
+    hash[0] = FNV_OFFSET;
+    for (int i = 0; i < n; i++) {
+        hash[i + 1] = _hash_comp(hash[i], name->comp[i], name->complen[i]);
+    }
+    for (int compcnt = n; compcnt > 0; compcnt--) {
+        if (idx->lens & (1U << compcnt)) {
+            struct ccnl_forward_s *fwd = _find(idx, name, compcnt, hash[compcnt]);
+            if (fwd) {
+                return fwd;
+            }
+        }
+    }
+    return NULL;
+}
+
+struct ccnl_forward_s *fib_idx_at(fib_idx_t *idx, unsigned i)
+{
+    return (i < idx->used) ? idx->pool[i].fwd : NULL;
+}
+
+/* what the relay does per Interest: walk the whole list for the longest match */
+static struct ccnl_forward_s *_list_lookup(struct ccnl_forward_s *fib,
+                                           struct ccnl_prefix_s *name)
+{
+    struct ccnl_forward_s *best = NULL;
+
+    for (struct ccnl_forward_s *fwd = fib; fwd; fwd = fwd->next) {
+        int rc = ccnl_prefix_cmp(fwd->prefix, NULL, name, CMP_LONGEST);
+        if ((rc >= fwd->prefix->compcnt) &&
+            (!best || (fwd->prefix->compcnt > best->prefix->compcnt))) {
+            best = fwd;
+        }
+    }
+    return best;
+}
+
+static void _bench_print(unsigned n, const char *backend, uint32_t usec)
+{
+    /* FIBBENCH;<entries>;<backend>;<lookups>;<usec>;<lookups/s> */
+    printf("FIBBENCH;%u;%s;%u;%lu;%lu\n", n, backend, FIB_IDX_BENCH_LOOKUPS,
+           (unsigned long)usec,
+           (unsigned long)(((uint64_t)FIB_IDX_BENCH_LOOKUPS * US_PER_SEC) /
+                           (usec ? usec : 1)));
+}
+
+static void _bench(unsigned n)
+{
+    struct ccnl_forward_s *fwd = calloc(n, sizeof(*fwd));
+    struct ccnl_prefix_s *names[FIB_IDX_BENCH_NAMES] = { NULL };
+    unsigned buckets = 1;
+    fib_idx_entry_t **bucket;
+    fib_idx_entry_t *pool = calloc(n, sizeof(*pool));
+    fib_idx_t idx;
+    char uri[48];
+    unsigned miss = 0, i;
+    uint32_t start;
+
+    while (buckets < n) {
+        buckets <<= 1;
+    }
+    bucket = malloc(buckets * sizeof(*bucket));
+    if (!fwd || !pool || !bucket) {
+        printf("FIBBENCH;%u;out of memory\n", n);
+        goto out;
+    }
+    fib_idx_init(&idx, bucket, buckets, pool, n);
+    /* /i3/<hwaddr> as cb_published() adds them, all on the same face */
+    for (i = 0; i < n; i++) {
+        snprintf(uri, sizeof(uri), "/i3/00:00:00:00:00:00:%02x:%02x",
+                 (i >> 8) & 0xff, i & 0xff);
+        fwd[i].prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+        if (!fwd[i].prefix) {
+            printf("FIBBENCH;%u;out of memory\n", n);
+            goto out;
+        }
+        fwd[i].suite = CCNL_SUITE_NDNTLV;
+        fwd[i].next = (i + 1 < n) ? &fwd[i + 1] : NULL;
+        fib_idx_add(&idx, &fwd[i]);
+    }
+    /* requests spread over the FIB */
+    for (i = 0; i < FIB_IDX_BENCH_NAMES; i++) {
+        unsigned e = (i * 7919U) % n;
+        snprintf(uri, sizeof(uri), "/i3/00:00:00:00:00:00:%02x:%02x/gasval/%04u",
+                 (e >> 8) & 0xff, e & 0xff, i);
+        names[i] = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+        if (!names[i]) {
+            printf("FIBBENCH;%u;out of memory\n", n);
+            goto out;
+        }
+    }
+
+    start = xtimer_now_usec();
+    for (i = 0; i < FIB_IDX_BENCH_LOOKUPS; i++) {
+        if (!_list_lookup(fwd, names[i % FIB_IDX_BENCH_NAMES])) {
+            miss++;
+        }
+    }
+    _bench_print(n, "list", xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (i = 0; i < FIB_IDX_BENCH_LOOKUPS; i++) {
+        if (!fib_idx_lookup(&idx, names[i % FIB_IDX_BENCH_NAMES])) {
+            miss++;
+        }
+    }
+    _bench_print(n, "hash", xtimer_now_usec() - start);
+
+    miss = 0;
+    for (i = 0; i < FIB_IDX_BENCH_NAMES; i++) {
+        if (_list_lookup(fwd, names[i]) != fib_idx_lookup(&idx, names[i])) {
+            miss++;
+        }
+    }
+    if (miss) {
+        printf("FIBBENCH;%u;mismatch;%u\n", n, miss);
+    }
+
+out:
+    for (i = 0; i < FIB_IDX_BENCH_NAMES; i++) {
+        if (names[i]) {
+            ccnl_prefix_free(names[i]);
+        }
+    }
+    if (fwd) {
+        for (i = 0; i < n; i++) {
+            if (fwd[i].prefix) {
+                ccnl_prefix_free(fwd[i].prefix);
+            }
+        }
+    }
+    free(bucket);
+    free(pool);
+    free(fwd);
+}
+
+int fib_idx_bench(int argc, char **argv)
+{
+    static const unsigned sizes[] = { 50, 200, 1000 };
+
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n <= 0) {
+            printf("usage: %s [entries]\n", argv[0]);
+            return 1;
+        }
+        _bench(n);
+        return 0;
+    }
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        _bench(sizes[i]);
+    }
+    return 0;
+}
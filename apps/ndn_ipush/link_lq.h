@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Link-quality-aware HoPP parent selection
+ *
+ * HoPP picks its parent by rank from the PAMs it hears, whatever the link
+ * they came over. A thread in front of the relay averages the link quality
+ * indicator (LQI) of every frame per neighbour. Broadcast HoPP messages
+ * (PAMs) from neighbours whose link turned bad are dropped before HoPP
+ * sees them, so HoPP joins, and moves on, to parents over good links only.
+ * This also holds while the node has no rank, e.g. after HoPP's parent
+ * timeout. Unicast messages, i.e. NAMs from children, always pass.
+ *
+ * The current parent's PAMs are never dropped: HoPP only leaves its parent
+ * for a neighbour with a better rank or when the parent times out, so
+ * silencing the parent would only leave the node without one for
+ * HOPP_PARENT_TIMEOUT_PERIOD_BASE. A parent whose link turned bad is kept
+ * until a good link offers a better rank. If every neighbour heard is bad,
+ * all PAMs pass, as any parent is better than none.
+ *
+ * A link turns bad when its average drops below LINK_LQ_LOW and good again
+ * only above LINK_LQ_HIGH, so a link near one threshold does not flap.
+ * Every neighbour starts good and is judged after LINK_LQ_MIN_FRAMES.
+ *
+ * @}
+ */
+
+#ifndef LINK_LQ_H
+#define LINK_LQ_H
+
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LINK_LQ_LOW
+#define LINK_LQ_LOW             (160)
+#endif
+
+#ifndef LINK_LQ_HIGH
+#define LINK_LQ_HIGH            (200)
+#endif
+
+#ifndef LINK_LQ_MIN_FRAMES
+#define LINK_LQ_MIN_FRAMES      (4)
+#endif
+
+/* weight of a new sample in the average is 1/2^LINK_LQ_SHIFT */
+#ifndef LINK_LQ_SHIFT
+#define LINK_LQ_SHIFT           (3)
+#endif
+
+/* neighbours tracked, further ones always count as good */
+#ifndef LINK_LQ_NEIGH_NUMOF
+#define LINK_LQ_NEIGH_NUMOF     (16)
+#endif
+
+/* same priority as the relay would starve it, hand over one frame each */
+#ifndef LINK_LQ_PRIO
+#define LINK_LQ_PRIO            (CCNL_THREAD_PRIORITY + 1)
+#endif
+
+#ifndef LINK_LQ_MBOX_SIZE
+#define LINK_LQ_MBOX_SIZE       (32)
+#endif
+
+/**
+ * @brief   Start the thread in front of the relay
+ *
+ * Call after ccnl_open_netif().
+ *
+ * @param[in] netif     interface whose delivery counters are reported
+ *
+ * @return  0 on success, -1 if the relay is not registered
+ */
+int link_lq_init(kernel_pid_t netif);
+
+/**
+ * @brief   Shell command printing rank changes, the delivery ratio and the
+ *          link quality per neighbour, "reset" clears the counters
+ */
+int link_lq_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_LQ_H */
@@ -23,13 +23,46 @@
 #include "ccnl-pkt-builder.h"
 #include "net/hopp/hopp.h"
 
+#ifdef FIB_INDEX
+#include "fib_idx.h"
+#endif
+#ifdef FIB_POOL
+#include "fib_pfx.h"
+#endif
+#ifdef CS_POLICY
+#include "cs_policy.h"
+#endif
+#ifdef CCNL_POOLS
+#include "ccnl_pool.h"
+#endif
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef I3_TLV
+#include "i3_tlv.h"
+#endif
+#ifdef RELAY_Q
+#include "relay_q.h"
+#endif
+#ifdef LINK_LQ
+#include "link_lq.h"
+#endif
+#ifdef L2_STATS
+#include "l2_stats.h"
+#endif
+
 /* main thread's message queue */
 #define MAIN_QUEUE_SIZE     (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
 #ifdef MODULE_TLSF
 /* buffer for the heap should be enough for everyone */
+#ifdef CCNL_POOLS
+/* the pools take their memory from the heap */
+#define TLSF_BUFFER     ((46080 - CCNL_POOL_BYTES) / sizeof(uint32_t))
+#else
 #define TLSF_BUFFER     (46080 / sizeof(uint32_t))
+#endif
 static uint32_t _tlsf_heap[TLSF_BUFFER];
 #endif
 
@@ -127,6 +160,9 @@ static int _req_start(int argc, char **argv)
 int producer_func(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_pkt_s *pkt){
     (void)from;
+#ifdef CS_POLICY
+    cs_policy_sample(relay, pkt);
+#endif
 
 /*    printf("%.*s ; %.*s ;%.*s ;%.*s ;%.*s\n", pkt->pfx->complen[0], pkt->pfx->comp[0], 
                                               pkt->pfx->complen[1], pkt->pfx->comp[1], 
@@ -162,7 +198,11 @@ int producer_func(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             }
         }
     }
+#ifdef CS_INDEX
+    return cs_idx_serve(relay, from, pkt);
+#else
     return 0;
+#endif
 }
 
 static int _root(int argc, char **argv)
@@ -195,6 +235,35 @@ static int _hopp_end(int argc, char **argv) {
     return 0;
 }
 
+#ifdef FIB_POOL
+static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                         struct ccnl_face_s *from)
+{
+    struct ccnl_prefix_s *name = pkt->pfx;
+    struct ccnl_forward_s *fwd;
+
+    printf("PUBLISHED: /%.*s/%.*s\n", name->complen[0], name->comp[0],
+                                      name->complen[1], name->comp[1]);
+#ifdef FIB_INDEX
+    fwd = fib_idx_find(&fib_idx, name, 2);
+#else
+    fwd = fib_pfx_find(name, 2);
+#endif
+    from->flags |= CCNL_FACE_FLAGS_STATIC;
+    if (fwd) {
+        /* republished prefix, only its face may have changed */
+        fwd->face = from;
+        return;
+    }
+    if (!fib_pfx_add(relay, name, 2, from)) {
+        puts("FIB FULL");
+        return;
+    }
+#ifdef FIB_INDEX
+    fib_idx_sync(&fib_idx, relay->fib);
+#endif
+}
+#else
 static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
                          struct ccnl_face_s *from)
 {
@@ -206,6 +275,15 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
              "/%.*s/%.*s", pkt->pfx->complen[0], pkt->pfx->comp[0],
                            pkt->pfx->complen[1], pkt->pfx->comp[1]);
     printf("PUBLISHED: %s\n", scratch);
+#ifdef FIB_INDEX
+    /* republished prefix, only its face may have changed */
+    struct ccnl_forward_s *fwd = fib_idx_find(&fib_idx, pkt->pfx, 2);
+    if (fwd) {
+        from->flags |= CCNL_FACE_FLAGS_STATIC;
+        fwd->face = from;
+        return;
+    }
+#endif
     prefix = ccnl_URItoPrefix(scratch, CCNL_SUITE_NDNTLV, NULL, NULL);
 
     from->flags |= CCNL_FACE_FLAGS_STATIC;
@@ -213,8 +291,14 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
     if (ret != 0) {
         puts("FIB FULL");
     }
+#ifdef FIB_INDEX
+    else {
+        fib_idx_sync(&fib_idx, relay->fib);
+    }
+#endif
     ccnl_prefix_free(prefix);
 }
+#endif
 
 static int _publish(int argc, char **argv)
 {
@@ -260,6 +344,31 @@ static const shell_command_t shell_commands[] = {
     { "hp", "publish data", _publish },
     { "he", "HoPP end", _hopp_end },
     { "req_start", "start periodic publishes", _req_start },
+#ifdef FIB_INDEX
+    { "fib_bench", "benchmark FIB lookups, list vs. hash index", fib_idx_bench },
+#endif
+#ifdef CS_POLICY
+    { "cs", "print content store counters, \"cs reset\" clears them", cs_policy_stats },
+#endif
+#ifdef CCNL_POOLS
+    { "pools", "print CCN-lite pool use, \"pools reset\" clears it", ccnl_pool_stats },
+#endif
+#ifdef CS_INDEX
+    { "cs_bench", "benchmark CS lookups, list vs. hash index", cs_idx_bench },
+#endif
+#ifdef I3_TLV
+    { "tlv", "print packets decoded on the i3 fast path, \"tlv reset\" clears them", i3_tlv_stats },
+    { "tlv_bench", "benchmark NDN-TLV decoding, generic vs. i3 fast path", i3_tlv_bench },
+#endif
+#ifdef RELAY_Q
+    { "relayq", "print received frames queued and dropped per class, \"relayq reset\" clears them", relay_q_stats },
+#endif
+#ifdef LINK_LQ
+    { "link", "print rank changes, delivery ratio and link quality per neighbour, \"link reset\" clears them", link_lq_stats },
+#endif
+#ifdef L2_STATS
+    { "l2", "print link-layer unicast and broadcast frames, \"l2 reset\" clears them", l2_stats },
+#endif
 #ifdef MODULE_PKTCNT_FAST
     { "pktcnt_p", "print variables of pktcnt_fast module", _pktcnt_p },
 #else
@@ -281,17 +390,40 @@ int main(void)
     ccnl_core_init();
 
     ccnl_start();
+#ifdef CS_POLICY
+    cs_policy_init();
+#endif
+#ifdef CS_INDEX
+    cs_idx_attach();
+#endif
 
     /* get the default interface */
     gnrc_netif_t *netif = gnrc_netif_iter(NULL);
 
     gnrc_netapi_set(netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
 
-    /* set the relay's PID, configure the interface to use CCN nettype */
+    /* set the relay's PID, configure the interface to use CCN nettype.
+     * CCN-lite copies every received frame into a ccnl_buf_s, whose bytes
+     * are inline, and every packet it sends into a new snip. Both copies
+     * are inside the package's RIOT adaptation, wrapping ccnl_ll_TX() only
+     * sees the finished buffer, so the app cannot remove them. */
     if (ccnl_open_netif(netif->pid, GNRC_NETTYPE_CCN) < 0) {
         puts("Error registering at network interface!");
         return -1;
     }
+#ifdef L2_STATS
+    l2_stats_init(netif->pid);
+#endif
+#ifdef RELAY_Q
+    if (relay_q_init() < 0) {
+        return -1;
+    }
+#endif
+#ifdef LINK_LQ
+    if (link_lq_init(netif->pid) < 0) {
+        return -1;
+    }
+#endif
 
 #ifdef MODULE_GNRC_PKTDUMP
     gnrc_netreg_entry_t dump = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "ccn-lite-riot.h"
+#include "relay_q.h"
+
+#ifndef RELAY_Q_STACKSIZE
+#define RELAY_Q_STACKSIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/* in order of precedence */
+enum {
+    RELAY_Q_CTRL,
+    RELAY_Q_DATA,
+    RELAY_Q_INTEREST,
+    RELAY_Q_CLASSES,
+};
+
+typedef struct {
+    const char *name;
+    gnrc_pktsnip_t **ring;
+    unsigned size;
+    unsigned head;
+    unsigned len;
+    uint32_t queued;
+    uint32_t dropped;
+    unsigned high;
+} _class_t;
+
+static gnrc_pktsnip_t *_ctrl[RELAY_Q_CTRL_SIZE];
+static gnrc_pktsnip_t *_data[RELAY_Q_DATA_SIZE];
+static gnrc_pktsnip_t *_interest[RELAY_Q_INTEREST_SIZE];
+
+static _class_t _classes[RELAY_Q_CLASSES] = {
+    { "ctrl", _ctrl, RELAY_Q_CTRL_SIZE, 0, 0, 0, 0, 0 },
+    { "data", _data, RELAY_Q_DATA_SIZE, 0, 0, 0, 0, 0 },
+    { "interest", _interest, RELAY_Q_INTEREST_SIZE, 0, 0, 0, 0, 0 },
+};
+
+static char _stack[RELAY_Q_STACKSIZE];
+static msg_t _mbox[RELAY_Q_MBOX_SIZE];
+static gnrc_netreg_entry_t _entry;
+static unsigned _pending;
+
+/* NDN packets start with their type, HoPP's messages use types of their own */
+static _class_t *_classify(gnrc_pktsnip_t *pkt)
+{
+    uint8_t typ = (pkt->size > 0) ? ((uint8_t *)pkt->data)[0] : 0;
+
+    switch (typ) {
+        case NDN_TLV_Data:
+            return &_classes[RELAY_Q_DATA];
+        case NDN_TLV_Interest:
+            return &_classes[RELAY_Q_INTEREST];
+        default:
+            return &_classes[RELAY_Q_CTRL];
+    }
+}
+
+static void _push(gnrc_pktsnip_t *pkt)
+{
+    _class_t *c = _classify(pkt);
+
+    if (c->len == c->size) {
+        c->dropped++;
+        gnrc_pktbuf_release(pkt);
+        return;
+    }
+    c->ring[(c->head + c->len) % c->size] = pkt;
+    c->queued++;
+    if (++c->len > c->high) {
+        c->high = c->len;
+    }
+    _pending++;
+}
+
+static gnrc_pktsnip_t *_pop(void)
+{
+    for (unsigned i = 0; i < RELAY_Q_CLASSES; i++) {
+        _class_t *c = &_classes[i];
+
+        if (c->len) {
+            gnrc_pktsnip_t *pkt = c->ring[c->head];
+
+            c->head = (c->head + 1) % c->size;
+            c->len--;
+            _pending--;
+            return pkt;
+        }
+    }
+    return NULL;
+}
+
+static void _sort(msg_t *m)
+{
+    if (m->type == GNRC_NETAPI_MSG_TYPE_RCV) {
+        _push(m->content.ptr);
+    }
+    else {
+        /* nothing else is registered for, pass it on as is */
+        msg_send(m, _ccnl_event_loop_pid);
+    }
+}
+
+static void *_loop(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_mbox, RELAY_Q_MBOX_SIZE);
+
+    while (1) {
+        msg_t m;
+
+        if (!_pending) {
+            msg_receive(&m);
+            _sort(&m);
+        }
+        /* sort everything that arrived while the relay was busy */
+        while (msg_try_receive(&m) == 1) {
+            _sort(&m);
+        }
+        if (!_pending) {
+            continue;
+        }
+        /* the relay preempts us right away and is idle when we return */
+        m.type = GNRC_NETAPI_MSG_TYPE_RCV;
+        m.content.ptr = _pop();
+        msg_send(&m, _ccnl_event_loop_pid);
+    }
+    return NULL;
+}
+
+int relay_q_init(void)
+{
+    gnrc_netreg_entry_t *relay = gnrc_netreg_lookup(GNRC_NETTYPE_CCN,
+                                                    GNRC_NETREG_DEMUX_CTX_ALL);
+    kernel_pid_t pid;
+
+    while (relay && (relay->target.pid != _ccnl_event_loop_pid)) {
+        relay = gnrc_netreg_getnext(relay);
+    }
+    if (!relay) {
+        puts("relay_q: relay not registered");
+        return -1;
+    }
+    pid = thread_create(_stack, sizeof(_stack), RELAY_Q_PRIO,
+                        THREAD_CREATE_STACKTEST, _loop, NULL, "relay_q");
+    if (pid <= KERNEL_PID_UNDEF) {
+        puts("relay_q: cannot start thread");
+        return -1;
+    }
+    gnrc_netreg_entry_init_pid(&_entry, GNRC_NETREG_DEMUX_CTX_ALL, pid);
+    gnrc_netreg_unregister(GNRC_NETTYPE_CCN, relay);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN, &_entry);
+    return 0;
+}
+
+int relay_q_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        for (unsigned i = 0; i < RELAY_Q_CLASSES; i++) {
+            _classes[i].queued = 0;
+            _classes[i].dropped = 0;
+            _classes[i].high = _classes[i].len;
+        }
+        return 0;
+    }
+    for (unsigned i = 0; i < RELAY_Q_CLASSES; i++) {
+        _class_t *c = &_classes[i];
+
+        /* RELAYQ;<class>;<size>;<queued>;<dropped>;<high-water mark> */
+        printf("RELAYQ;%s;%u;%lu;%lu;%u\n", c->name, c->size,
+               (unsigned long)c->queued, (unsigned long)c->dropped, c->high);
+    }
+    return 0;
+}
@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "mutex.h"
+#include "thread.h"
+#include "utlist.h"
+#include "xtimer.h"
+#include "net/gnrc/netapi.h"
+#include "net/gnrc/netif.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "ccn-lite-riot.h"
+#include "ccnl-pkt-builder.h"
+#include "persist.h"
+
+#ifndef PERSIST_STACKSIZE
+#define PERSIST_STACKSIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/* /<prefix>/<id>/gasval/<seq or subscription> */
+#define PERSIST_COMPS           (4)
+#define PERSIST_ID_LEN          (GNRC_NETIF_L2ADDR_MAXLEN * 3)
+#define PERSIST_URI_LEN         (64)
+
+typedef struct {
+    bool used;
+    bool local;             /* our own consumer, not a downstream node */
+    char id[PERSIST_ID_LEN];
+    size_t id_len;
+    uint8_t addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    uint8_t addr_len;
+    uint32_t expires;
+} _sub_t;
+
+typedef struct {
+    unsigned char *comp[PERSIST_COMPS];
+    int len[PERSIST_COMPS];
+    int cnt;
+} _name_t;
+
+static struct {
+    uint32_t subs;          /* subscription Interests received */
+    uint32_t acks;
+    uint32_t subscribed;    /* subscription Interests sent */
+    uint32_t published;
+    uint32_t pushed;        /* readings sent by the producer */
+    uint32_t forwarded;     /* readings sent on by a relay */
+    uint32_t delivered;
+    uint32_t expired;
+    uint32_t full;
+} _stats;
+
+static _sub_t _subs[PERSIST_NUMOF];
+static mutex_t _lock = MUTEX_INIT;
+
+static char _stack[PERSIST_STACKSIZE];
+static msg_t _mbox[PERSIST_MBOX_SIZE];
+static gnrc_netreg_entry_t _entry;
+static kernel_pid_t _netif;
+static const char *_prefix;
+static const char *_id;
+static unsigned _refresh;
+
+static bool _is(const unsigned char *comp, int len, const char *s)
+{
+    return (len == (int)strlen(s)) && !memcmp(comp, s, len);
+}
+
+static bool _is_sub(const unsigned char *comp, int len)
+{
+    return (len >= (int)(sizeof(PERSIST_SUB) - 1)) &&
+           !memcmp(comp, PERSIST_SUB, sizeof(PERSIST_SUB) - 1);
+}
+
+static bool _expired(_sub_t *s, uint32_t now)
+{
+    return (int32_t)(now - s->expires) >= 0;
+}
+
+/* type and the first PERSIST_COMPS name components of an NDN packet */
+static int _parse(unsigned char *data, int len, int *typ, _name_t *name)
+{
+    int ntyp, vallen;
+
+    if (ccnl_ndntlv_dehead(&data, &len, typ, &vallen) || (vallen > len)) {
+        return -1;
+    }
+    len = vallen;
+    if (ccnl_ndntlv_dehead(&data, &len, &ntyp, &vallen) ||
+        (vallen > len) || (ntyp != NDN_TLV_Name)) {
+        return -1;
+    }
+    len = vallen;
+    name->cnt = 0;
+    while (len > 0) {
+        int ctyp;
+
+        if (ccnl_ndntlv_dehead(&data, &len, &ctyp, &vallen) ||
+            (vallen > len) || (ctyp != NDN_TLV_NameComponent)) {
+            return -1;
+        }
+        if (name->cnt < PERSIST_COMPS) {
+            name->comp[name->cnt] = data;
+            name->len[name->cnt] = vallen;
+        }
+        name->cnt++;
+        data += vallen;
+        len -= vallen;
+    }
+    return 0;
+}
+
+/* caller holds _lock */
+static _sub_t *_get(const char *id, size_t id_len, bool local,
+                    const uint8_t *addr, uint8_t addr_len)
+{
+    uint32_t now = xtimer_now_usec();
+    _sub_t *free = NULL;
+
+    for (unsigned i = 0; i < PERSIST_NUMOF; i++) {
+        _sub_t *s = &_subs[i];
+
+        if (s->used && _expired(s, now)) {
+            s->used = false;
+            _stats.expired++;
+        }
+        if (!s->used) {
+            free = free ? free : s;
+            continue;
+        }
+        if ((s->local == local) && (s->id_len == id_len) &&
+            !memcmp(s->id, id, id_len) && (s->addr_len == addr_len) &&
+            !memcmp(s->addr, addr, addr_len)) {
+            return s;
+        }
+    }
+    if (!free || (id_len > sizeof(free->id)) ||
+        (addr_len > sizeof(free->addr))) {
+        _stats.full++;
+        return NULL;
+    }
+    free->used = true;
+    free->local = local;
+    memcpy(free->id, id, id_len);
+    free->id_len = id_len;
+    memcpy(free->addr, addr, addr_len);
+    free->addr_len = addr_len;
+    return free;
+}
+
+static int _subscribe(const char *id, size_t id_len, bool local,
+                      const uint8_t *addr, uint8_t addr_len)
+{
+    _sub_t *s;
+
+    mutex_lock(&_lock);
+    s = _get(id, id_len, local, addr, addr_len);
+    if (s) {
+        s->expires = xtimer_now_usec() + PERSIST_LIFETIME;
+    }
+    mutex_unlock(&_lock);
+    return s ? 0 : -1;
+}
+
+static int _send(const unsigned char *data, size_t len,
+                 const uint8_t *addr, uint8_t addr_len)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, data, len, GNRC_NETTYPE_CCN);
+    gnrc_pktsnip_t *hdr;
+
+    if (!pkt) {
+        return -1;
+    }
+    hdr = gnrc_netif_hdr_build(NULL, 0, addr, addr_len);
+    if (!hdr) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    LL_PREPEND(pkt, hdr);
+    if (gnrc_netapi_send(_netif, pkt) < 1) {
+        gnrc_pktbuf_release(pkt);
+        return -1;
+    }
+    return 0;
+}
+
+static void _deliver(_name_t *name)
+{
+#ifdef MODULE_PKTCNT_FAST
+    uint64_t now = xtimer_now_usec64();
+    printf("RECV;");
+    for (int i = 0; i < PERSIST_COMPS; i++) {
+        printf("/%.*s", name->len[i], name->comp[i]);
+    }
+    printf(";%lu%06lu\n",
+        (unsigned long)div_u64_by_1000000(now),
+        (unsigned long)now % US_PER_SEC);
+#else
+    (void)name;
+#endif
+    _stats.delivered++;
+}
+
+/* send a reading on to every subscriber of its producer but the sender */
+static bool _forward(gnrc_pktsnip_t *pkt, _name_t *name,
+                     const uint8_t *src, uint8_t src_len)
+{
+    uint32_t now = xtimer_now_usec();
+    bool taken = false;
+
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < PERSIST_NUMOF; i++) {
+        _sub_t *s = &_subs[i];
+
+        if (!s->used || _expired(s, now) ||
+            (s->id_len != (size_t)name->len[1]) ||
+            memcmp(s->id, name->comp[1], s->id_len)) {
+            continue;
+        }
+        taken = true;
+        if (s->local) {
+            _deliver(name);
+        }
+        else if ((s->addr_len != src_len) ||
+                 memcmp(s->addr, src, src_len)) {
+            if (_send(pkt->data, pkt->size, s->addr, s->addr_len) == 0) {
+                _stats.forwarded++;
+            }
+        }
+    }
+    mutex_unlock(&_lock);
+    return taken;
+}
+
+/* true if the frame was consumed and must not reach the relay */
+static bool _handle(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *nh = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_NETIF);
+    gnrc_netif_hdr_t *hdr;
+    _name_t name;
+    int typ;
+
+    if (!nh || _parse(pkt->data, pkt->size, &typ, &name) ||
+        (name.cnt != PERSIST_COMPS) ||
+        !_is(name.comp[0], name.len[0], _prefix) ||
+        !_is(name.comp[2], name.len[2], "gasval")) {
+        return false;
+    }
+    hdr = nh->data;
+    if (_is_sub(name.comp[3], name.len[3])) {
+        if (typ == NDN_TLV_Interest) {
+            /* the relay still forwards it, towards the producer */
+            _stats.subs++;
+            _subscribe((char *)name.comp[1], name.len[1], false,
+                       gnrc_netif_hdr_get_src_addr(hdr), hdr->src_l2addr_len);
+        }
+        return false;
+    }
+    if ((typ != NDN_TLV_Data) ||
+        !_forward(pkt, &name, gnrc_netif_hdr_get_src_addr(hdr),
+                  hdr->src_l2addr_len)) {
+        return false;
+    }
+    gnrc_pktbuf_release(pkt);
+    return true;
+}
+
+static void *_loop(void *arg)
+{
+    (void)arg;
+    msg_init_queue(_mbox, PERSIST_MBOX_SIZE);
+
+    while (1) {
+        msg_t m;
+
+        msg_receive(&m);
+        if ((m.type == GNRC_NETAPI_MSG_TYPE_RCV) && _handle(m.content.ptr)) {
+            continue;
+        }
+        msg_send(&m, _ccnl_event_loop_pid);
+    }
+    return NULL;
+}
+
+int persist_init(kernel_pid_t netif, const char *prefix, const char *id)
+{
+    gnrc_netreg_entry_t *relay = gnrc_netreg_lookup(GNRC_NETTYPE_CCN,
+                                                    GNRC_NETREG_DEMUX_CTX_ALL);
+    kernel_pid_t pid;
+
+    while (relay && (relay->target.pid != _ccnl_event_loop_pid)) {
+        relay = gnrc_netreg_getnext(relay);
+    }
+    if (!relay) {
+        puts("persist: relay not registered");
+        return -1;
+    }
+    _netif = netif;
+    _prefix = prefix;
+    _id = id;
+    pid = thread_create(_stack, sizeof(_stack), PERSIST_PRIO,
+                        THREAD_CREATE_STACKTEST, _loop, NULL, "persist");
+    if (pid <= KERNEL_PID_UNDEF) {
+        puts("persist: cannot start thread");
+        return -1;
+    }
+    gnrc_netreg_entry_init_pid(&_entry, GNRC_NETREG_DEMUX_CTX_ALL, pid);
+    gnrc_netreg_unregister(GNRC_NETTYPE_CCN, relay);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN, &_entry);
+    return 0;
+}
+
+int persist_subscribe(const char *id, size_t id_len, char *uri, size_t len)
+{
+    if (_subscribe(id, id_len, true, NULL, 0) < 0) {
+        return -1;
+    }
+    _stats.subscribed++;
+    return snprintf(uri, len, "/%s/%.*s/gasval/%s%04u", _prefix, (int)id_len,
+                    id, PERSIST_SUB, _refresh++);
+}
+
+int persist_ack(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_prefix_s *name = pkt->pfx;
+    unsigned char ack[] = "ACK";
+    struct ccnl_content_s *c;
+
+    if ((name->compcnt != PERSIST_COMPS) ||
+        !_is(name->comp[0], name->complen[0], _prefix) ||
+        !_is(name->comp[1], name->complen[1], _id) ||
+        !_is_sub(name->comp[3], name->complen[3])) {
+        return 0;
+    }
+    c = ccnl_mkContentObject(name, ack, sizeof(ack), NULL);
+    if (!c) {
+        return 0;
+    }
+    /* stale right away, a refresh must reach us again */
+    c->last_used -= CCNL_CONTENT_TIMEOUT + 5;
+    ccnl_content_add2cache(relay, c);
+    _stats.acks++;
+    return 0;
+}
+
+int persist_publish(unsigned seq, const char *data, size_t len)
+{
+    char uri[PERSIST_URI_LEN];
+    struct ccnl_prefix_s *name;
+    struct ccnl_buf_s *buf;
+    uint32_t now = xtimer_now_usec();
+    size_t id_len = strlen(_id);
+    int num = 0;
+
+    snprintf(uri, sizeof(uri), "/%s/%s/gasval/%04u", _prefix, _id, seq);
+    name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    if (!name) {
+        return 0;
+    }
+    buf = ccnl_mkSimpleContent(name, (unsigned char *)data, len, NULL, NULL);
+    ccnl_prefix_free(name);
+    if (!buf) {
+        return 0;
+    }
+    mutex_lock(&_lock);
+    for (unsigned i = 0; i < PERSIST_NUMOF; i++) {
+        _sub_t *s = &_subs[i];
+
+        if (!s->used || s->local || _expired(s, now) ||
+            (s->id_len != id_len) || memcmp(s->id, _id, id_len)) {
+            continue;
+        }
+        if (_send(buf->data, buf->datalen, s->addr, s->addr_len) == 0) {
+            num++;
+        }
+    }
+    mutex_unlock(&_lock);
+    ccnl_free(buf);
+    _stats.published++;
+    _stats.pushed += num;
+    return num;
+}
+
+int persist_stats(int argc, char **argv)
+{
+    uint32_t now = xtimer_now_usec();
+    unsigned live = 0;
+
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    for (unsigned i = 0; i < PERSIST_NUMOF; i++) {
+        if (_subs[i].used && !_expired(&_subs[i], now)) {
+            live++;
+        }
+    }
+    /* PERSIST;<subscriptions held>;<received>;<acked>;<sent>;<readings>;
+     *         <pushed>;<forwarded>;<delivered>;<expired>;<table full> */
+    printf("PERSIST;%u;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n", live,
+           (unsigned long)_stats.subs, (unsigned long)_stats.acks,
+           (unsigned long)_stats.subscribed, (unsigned long)_stats.published,
+           (unsigned long)_stats.pushed, (unsigned long)_stats.forwarded,
+           (unsigned long)_stats.delivered, (unsigned long)_stats.expired,
+           (unsigned long)_stats.full);
+    return 0;
+}
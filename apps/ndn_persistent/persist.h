@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Persistent Interests for NDN pub/sub
+ *
+ * A consumer subscribes to a producer with one Interest for
+ * /<prefix>/<id>/gasval/sub<n> and repeats it every PERSIST_REFRESH. The
+ * Interest travels along the FIB route HoPP installed towards the producer
+ * like any other, and the producer acknowledges it with a stale Data that
+ * clears the PIT entries on its way back.
+ *
+ * CCN-lite drops a PIT entry as soon as one Data satisfies it and drops
+ * Data nobody asked for. So every node keeps its own persistent PIT, from a
+ * thread that takes over the relay's registration for received frames:
+ * each subscription Interest passing through records the link-layer address
+ * of the downstream node for PERSIST_LIFETIME. The producer sends each new
+ * reading to its subscribers, and every relay forwards received readings to
+ * its own subscribers instead of handing them to the relay. Upstream, a
+ * reading costs nothing but the subscription refreshes.
+ *
+ * @}
+ */
+
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* last name component of a subscription Interest, followed by a counter */
+#define PERSIST_SUB             "sub"
+
+/* how long a node keeps a subscription */
+#ifndef PERSIST_LIFETIME
+#define PERSIST_LIFETIME        (120U * US_PER_SEC)
+#endif
+
+/* how often a consumer renews its subscriptions */
+#ifndef PERSIST_REFRESH
+#define PERSIST_REFRESH         (90U * US_PER_SEC)
+#endif
+
+/* subscriptions a node keeps, local and downstream */
+#ifndef PERSIST_NUMOF
+#define PERSIST_NUMOF           (32)
+#endif
+
+/* same priority as the relay would starve it, hand over one frame each */
+#ifndef PERSIST_PRIO
+#define PERSIST_PRIO            (CCNL_THREAD_PRIORITY + 1)
+#endif
+
+#ifndef PERSIST_MBOX_SIZE
+#define PERSIST_MBOX_SIZE       (32)
+#endif
+
+/**
+ * @brief   Start the thread in front of the relay
+ *
+ * Call after ccnl_open_netif().
+ *
+ * @param[in] netif     interface readings are sent on
+ * @param[in] prefix    first name component, without slash
+ * @param[in] id        this node's name component
+ *
+ * @return  0 on success, -1 if the relay is not registered
+ */
+int persist_init(kernel_pid_t netif, const char *prefix, const char *id);
+
+/**
+ * @brief   Consumer: subscribe to producer @p id, then send the Interest
+ *          for the name written to @p uri
+ *
+ * @return  length of @p uri, -1 if no subscription is left
+ */
+int persist_subscribe(const char *id, size_t id_len, char *uri, size_t len);
+
+/**
+ * @brief   Producer: acknowledge a subscription Interest for this node
+ *
+ * Call from the local producer function.
+ *
+ * @return  0, the relay answers from its CS
+ */
+int persist_ack(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief   Producer: send a reading to all subscribers of this node
+ *
+ * @return  number of subscribers sent to
+ */
+int persist_publish(unsigned seq, const char *data, size_t len);
+
+/**
+ * @brief   Shell command printing subscriptions, readings pushed, forwarded
+ *          and delivered, "reset" clears them
+ */
+int persist_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERSIST_H */
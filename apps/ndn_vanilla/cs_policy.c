@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* only built with a policy selected, see the Makefile */
+#ifdef CS_POLICY
+
+#include <stdio.h>
+#include <string.h>
+
+#include "random.h"
+
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef NACK
+#include "nack.h"
+#endif
+#include "cs_policy.h"
+
+#if defined(CS_POLICY_LRU)
+#define CS_POLICY_NAME          "lru"
+#elif defined(CS_POLICY_LFU)
+#define CS_POLICY_NAME          "lfu"
+#elif defined(CS_POLICY_FIFO)
+#define CS_POLICY_NAME          "fifo"
+#elif defined(CS_POLICY_FRESH)
+#define CS_POLICY_NAME          "fresh"
+#elif defined(CS_POLICY_PROB)
+#define CS_POLICY_NAME          "prob"
+#else
+#error "unknown CS_POLICY, use LRU, LFU, FIFO, FRESH or PROB"
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t admitted;          /* forwarded Data the policy let in */
+    uint32_t rejected;
+} _stats_t;
+
+static _stats_t _stats;
+
+static inline int _evictable(struct ccnl_content_s *c)
+{
+    return !(c->flags & CCNL_CONTENT_FLAGS_STATIC);
+}
+
+/* older than the relay's content timeout, compared to the new entry */
+static inline int _stale(struct ccnl_content_s *c, struct ccnl_content_s *new)
+{
+    return (new->last_used - c->last_used) > CCNL_CONTENT_TIMEOUT;
+}
+
+#if defined(CS_POLICY_FRESH)
+/* same name but for the last component */
+static int _same_producer(struct ccnl_prefix_s *a, struct ccnl_prefix_s *b)
+{
+    if ((a->compcnt != b->compcnt) || (a->compcnt < 2)) {
+        return 0;
+    }
+    for (int i = a->compcnt - 2; i >= 0; i--) {
+        if ((a->complen[i] != b->complen[i]) ||
+            memcmp(a->comp[i], b->comp[i], a->complen[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* sequence numbers are decimal, shorter is lower */
+static int _seq_cmp(struct ccnl_prefix_s *a, struct ccnl_prefix_s *b)
+{
+    int n = a->compcnt - 1;
+
+    if (a->complen[n] != b->complen[n]) {
+        return a->complen[n] - b->complen[n];
+    }
+    return memcmp(a->comp[n], b->comp[n], a->complen[n]);
+}
+#endif
+
+static struct ccnl_content_s *_victim(struct ccnl_relay_s *relay,
+                                      struct ccnl_content_s *new)
+{
+    struct ccnl_content_s *victim = NULL;
+#if defined(CS_POLICY_FRESH)
+    struct ccnl_content_s *oldest_seq = NULL;
+#endif
+
+    for (struct ccnl_content_s *c = relay->contents; c; c = c->next) {
+        if (!_evictable(c)) {
+            continue;
+        }
+        if (_stale(c, new)) {
+            return c;
+        }
+#if defined(CS_POLICY_FIFO)
+        /* the relay inserts at the head, the last entry is the oldest */
+        victim = c;
+#else
+#if defined(CS_POLICY_LFU)
+        if (victim && (c->served_cnt != victim->served_cnt)) {
+            if (c->served_cnt < victim->served_cnt) {
+                victim = c;
+            }
+            continue;
+        }
+#elif defined(CS_POLICY_FRESH)
+        if (_same_producer(c->pkt->pfx, new->pkt->pfx) &&
+            (!oldest_seq || (_seq_cmp(c->pkt->pfx, oldest_seq->pkt->pfx) < 0))) {
+            oldest_seq = c;
+        }
+#endif
+        if (!victim || (c->last_used < victim->last_used)) {
+            victim = c;
+        }
+#endif
+    }
+#if defined(CS_POLICY_FRESH)
+    if (oldest_seq) {
+        return oldest_seq;
+    }
+#endif
+    return victim;
+}
+
+static int _remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_content_s *victim;
+
+    if ((relay->max_cache_entries <= 0) ||
+        (relay->contentcnt < relay->max_cache_entries)) {
+        return 1;
+    }
+    victim = _victim(relay, c);
+    if (!victim) {
+        return 0;
+    }
+    ccnl_content_remove(relay, victim);
+    _stats.evictions++;
+    return 1;
+}
+
+static int _cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    (void)relay;
+    (void)c;
+#ifdef NACK
+    /* not counted as rejected, the policy did not see it */
+    if (!nack_cache(relay, c)) {
+        return 0;
+    }
+#endif
+#if defined(CS_POLICY_PROB)
+    if (random_uint32_range(0, 100) >= CS_INSERT_PROB) {
+        _stats.rejected++;
+        return 0;
+    }
+#endif
+    _stats.admitted++;
+    return 1;
+}
+
+void cs_policy_init(void)
+{
+    ccnl_set_cache_strategy_remove(_remove);
+    ccnl_set_cache_strategy_cache(_cache);
+}
+
+void cs_policy_sample(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
+{
+#ifdef CS_INDEX
+    if (cs_idx_lookup(&cs_idx, relay, pkt->pfx)) {
+        _stats.hits++;
+        return;
+    }
+#else
+    for (struct ccnl_content_s *c = relay->contents; c; c = c->next) {
+        if (!ccnl_prefix_cmp(c->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) {
+            _stats.hits++;
+            return;
+        }
+    }
+#endif
+    _stats.misses++;
+}
+
+int cs_policy_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    unsigned long bytes = 0;
+    uint32_t requests = _stats.hits + _stats.misses;
+
+    for (struct ccnl_content_s *c = ccnl_relay.contents; c; c = c->next) {
+        bytes += c->pkt->buf->datalen;
+    }
+    /* CS;<policy>;<entries>;<max>;<bytes>;<hits>;<misses>;<hit %>;
+     *    <evictions>;<admitted>;<rejected> */
+    printf("CS;%s;%d;%d;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n", CS_POLICY_NAME,
+           ccnl_relay.contentcnt, ccnl_relay.max_cache_entries, bytes,
+           (unsigned long)_stats.hits, (unsigned long)_stats.misses,
+           (unsigned long)(requests ? (_stats.hits * 100UL) / requests : 0),
+           (unsigned long)_stats.evictions, (unsigned long)_stats.admitted,
+           (unsigned long)_stats.rejected);
+    return 0;
+}
+
+#endif /* CS_POLICY */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Content Store replacement policies and hit statistics
+ *
+ * The policy is selected at build time with CS_POLICY_<name>:
+ * - LRU:   evict the least recently used entry
+ * - LFU:   evict the least often served entry, LRU among equals
+ * - FIFO:  evict the oldest entry
+ * - FRESH: evict the lowest sequence number of the incoming Data's
+ *          producer, LRU if the store holds none of its Data
+ * - PROB:  cache forwarded Data with CS_INSERT_PROB percent, evict LRU
+ *
+ * All policies evict entries that are already stale first, e.g. the ACKs
+ * ndn_ipush ages on purpose. Static entries are never evicted. With NACK,
+ * NACKs received from other relays are never admitted, see nack.h.
+ *
+ * @}
+ */
+
+#ifndef CS_POLICY_H
+#define CS_POLICY_H
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* percentage of forwarded Data the PROB policy caches */
+#ifndef CS_INSERT_PROB
+#define CS_INSERT_PROB          (50)
+#endif
+
+/**
+ * @brief   Install the policy in the relay
+ */
+void cs_policy_init(void);
+
+/**
+ * @brief   Count a hit or miss for the incoming Interest @p pkt
+ *
+ * Must be called from the relay thread, e.g. from the local producer.
+ */
+void cs_policy_sample(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief   Shell command printing the CS counters, "reset" clears them
+ */
+int cs_policy_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CS_POLICY_H */
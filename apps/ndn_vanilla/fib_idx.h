@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Hash index over the relay's FIB
+ *
+ * Every indexed prefix is hashed component by component, so the hashes of
+ * all prefixes of a name fall out of a single pass over it. A longest-prefix
+ * match then probes the longest indexed prefix length first and compares
+ * components only on a hash hit.
+ *
+ * The index only points into ccnl_relay.fib and keeps its insertion order,
+ * which is the order of the FIB list. Entries are never removed, so indexed
+ * FIB entries must stay in place (static faces).
+ *
+ * @}
+ */
+
+#ifndef FIB_IDX_H
+#define FIB_IDX_H
+
+#include <stdint.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* number of FIB entries indexed for the relay */
+#ifndef FIB_IDX_NUMOF
+#define FIB_IDX_NUMOF           (64)
+#endif
+
+/* number of hash buckets for the relay, must be a power of two */
+#ifndef FIB_IDX_BUCKETS
+#define FIB_IDX_BUCKETS         (32)
+#endif
+
+/* prefixes with more components are not indexed */
+#define FIB_IDX_COMPCNT_MAX     (8)
+
+typedef struct fib_idx_entry {
+    struct fib_idx_entry *next;     /* next entry in the same bucket */
+    struct ccnl_forward_s *fwd;
+    uint32_t hash;
+} fib_idx_entry_t;
+
+typedef struct {
+    fib_idx_entry_t **bucket;
+    unsigned mask;                  /* number of buckets - 1 */
+    fib_idx_entry_t *pool;          /* entries in insertion order */
+    unsigned numof;
+    unsigned used;
+    uint32_t lens;                  /* bit n set: prefixes of n components */
+} fib_idx_t;
+
+/**
+ * @brief   Index of ccnl_relay.fib
+ */
+extern fib_idx_t fib_idx;
+
+/**
+ * @brief   Set up an empty index on caller-provided memory
+ *
+ * @param[in] buckets   number of @p bucket, a power of two
+ */
+void fib_idx_init(fib_idx_t *idx, fib_idx_entry_t **bucket, unsigned buckets,
+                  fib_idx_entry_t *pool, unsigned numof);
+
+/**
+ * @brief   Add a FIB entry to the index
+ *
+ * @return  0 on success, -1 if the index is full or the prefix too long
+ */
+int fib_idx_add(fib_idx_t *idx, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief   Index the FIB entries appended to @p fib since the last call
+ *
+ * @return  0 on success, -1 if an entry could not be indexed
+ */
+int fib_idx_sync(fib_idx_t *idx, struct ccnl_forward_s *fib);
+
+/**
+ * @brief   Find the entry whose prefix equals the first @p compcnt
+ *          components of @p name
+ */
+struct ccnl_forward_s *fib_idx_find(fib_idx_t *idx, struct ccnl_prefix_s *name,
+                                    int compcnt);
+
+/**
+ * @brief   Component-wise longest-prefix match of @p name
+ */
+struct ccnl_forward_s *fib_idx_lookup(fib_idx_t *idx, struct ccnl_prefix_s *name);
+
+/**
+ * @brief   The @p i th indexed entry, which is the @p i th FIB entry
+ *
+ * @return  the entry, NULL if @p i is not indexed
+ */
+struct ccnl_forward_s *fib_idx_at(fib_idx_t *idx, unsigned i);
+
+/**
+ * @brief   Shell command comparing lookups/s of the FIB list and the index
+ *
+ * Runs for 50, 200 and 1000 entries, or for the number given.
+ */
+int fib_idx_bench(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIB_IDX_H */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc/netif.h"
+
+#include "i3_name.h"
+
+static int _seq_len(uint32_t seq)
+{
+    return (seq <= UINT8_MAX) ? 1 : (seq <= UINT16_MAX) ? 2 : 4;
+}
+
+int i3_name_seq_encode(uint32_t seq, unsigned char *buf)
+{
+    int len = _seq_len(seq);
+
+    for (int i = len - 1; i >= 0; i--) {
+        buf[i] = seq & 0xff;
+        seq >>= 8;
+    }
+    return len;
+}
+
+int i3_name_seq_decode(const unsigned char *buf, int len, uint32_t *seq)
+{
+    if ((len != 1) && (len != 2) && (len != 4)) {
+        return -1;
+    }
+    *seq = 0;
+    for (int i = 0; i < len; i++) {
+        *seq = (*seq << 8) | buf[i];
+    }
+    /* 0x0001 is a different name than 0x01, only the shortest one matches */
+    return (_seq_len(*seq) == len) ? 0 : -1;
+}
+
+struct ccnl_prefix_s *i3_name_prefix(const char *prefix, const uint8_t *hwaddr,
+                                     size_t hwaddr_len)
+{
+    char uri[16];
+    struct ccnl_prefix_s *name;
+
+    snprintf(uri, sizeof(uri), "/%s", prefix);
+    name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    if (name &&
+        (ccnl_prefix_appendCmp(name, (unsigned char *)hwaddr, hwaddr_len) < 0)) {
+        ccnl_prefix_free(name);
+        return NULL;
+    }
+    return name;
+}
+
+int i3_name_append_seq(struct ccnl_prefix_s *name, uint32_t seq)
+{
+    unsigned char buf[I3_NAME_SEQ_MAXLEN];
+    int len = i3_name_seq_encode(seq, buf);
+
+    if ((ccnl_prefix_appendCmp(name, (unsigned char *)"gasval", 6) < 0) ||
+        (ccnl_prefix_appendCmp(name, buf, len) < 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+size_t i3_name_hwaddr(const struct ccnl_prefix_s *published, uint8_t *hwaddr)
+{
+    char str[GNRC_NETIF_L2ADDR_MAXLEN * 3];
+
+    if ((published->compcnt < 2) ||
+        (published->complen[1] >= (int)sizeof(str))) {
+        return 0;
+    }
+    memcpy(str, published->comp[1], published->complen[1]);
+    str[published->complen[1]] = '\0';
+    return gnrc_netif_addr_from_str(str, hwaddr);
+}
+
+struct ccnl_prefix_s *i3_name_from_published(struct ccnl_prefix_s *published)
+{
+    char prefix[16];
+    uint8_t hwaddr[GNRC_NETIF_L2ADDR_MAXLEN];
+    size_t hwaddr_len;
+
+    if ((published->compcnt < 2) ||
+        (published->complen[0] >= (int)sizeof(prefix))) {
+        return NULL;
+    }
+    memcpy(prefix, published->comp[0], published->complen[0]);
+    prefix[published->complen[0]] = '\0';
+    hwaddr_len = i3_name_hwaddr(published, hwaddr);
+    if (!hwaddr_len) {
+        return NULL;
+    }
+    return i3_name_prefix(prefix, hwaddr, hwaddr_len);
+}
+
+char *i3_name_to_str(struct ccnl_prefix_s *name, char *buf, size_t len)
+{
+    char str[GNRC_NETIF_L2ADDR_MAXLEN * 3];
+    uint32_t seq;
+
+    buf[0] = '\0';
+    if ((name->compcnt != 4) ||
+        (name->complen[1] > GNRC_NETIF_L2ADDR_MAXLEN) ||
+        i3_name_seq_decode(name->comp[3], name->complen[3], &seq)) {
+        return buf;
+    }
+    gnrc_netif_addr_to_str(name->comp[1], name->complen[1], str);
+    snprintf(buf, len, "/%.*s/%s/%.*s/%04lu",
+             name->complen[0], (char *)name->comp[0], str,
+             name->complen[2], (char *)name->comp[2], (unsigned long)seq);
+    return buf;
+}
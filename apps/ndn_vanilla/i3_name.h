@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Compact names in the i3 namespace
+ *
+ * A compact name is /<prefix>/<hwaddr>/gasval/<seq>. The hwaddr is the raw
+ * link-layer address (the EUI-64 on 802.15.4) instead of its colon separated
+ * hex string. The sequence number is a big-endian NDN nonNegativeInteger of
+ * 1, 2 or 4 bytes instead of %04d. Every sequence number has exactly one
+ * encoding, so consumer and producer always build the same name.
+ *
+ * HoPP publishes names as strings, so the published /<prefix>/<hwaddr string>
+ * is converted when it enters the FIB.
+ *
+ * @}
+ */
+
+#ifndef I3_NAME_H
+#define I3_NAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* longest encoding of a sequence number */
+#define I3_NAME_SEQ_MAXLEN      (4)
+
+/**
+ * @brief   Encode @p seq with as few bytes as possible
+ *
+ * @return  length written to @p buf, at most I3_NAME_SEQ_MAXLEN
+ */
+int i3_name_seq_encode(uint32_t seq, unsigned char *buf);
+
+/**
+ * @brief   Decode a sequence number component
+ *
+ * @return  0 on success, -1 if @p len is no valid length or longer than
+ *          i3_name_seq_encode() would write
+ */
+int i3_name_seq_decode(const unsigned char *buf, int len, uint32_t *seq);
+
+/**
+ * @brief   Build /<@p prefix>/<@p hwaddr> with a binary hwaddr
+ *
+ * @param[in] prefix    first component, e.g. "i3"
+ */
+struct ccnl_prefix_s *i3_name_prefix(const char *prefix, const uint8_t *hwaddr,
+                                     size_t hwaddr_len);
+
+/**
+ * @brief   Append gasval/<@p seq> to @p name
+ *
+ * @return  0 on success, -1 on error
+ */
+int i3_name_append_seq(struct ccnl_prefix_s *name, uint32_t seq);
+
+/**
+ * @brief   Parse the hwaddr string of a published /<prefix>/<hwaddr string>
+ *
+ * @param[out] hwaddr   at least GNRC_NETIF_L2ADDR_MAXLEN bytes
+ *
+ * @return  length of @p hwaddr, 0 on error
+ */
+size_t i3_name_hwaddr(const struct ccnl_prefix_s *published, uint8_t *hwaddr);
+
+/**
+ * @brief   Convert a published /<prefix>/<hwaddr string>[/...] into the
+ *          compact /<prefix>/<hwaddr>
+ *
+ * @return  the new prefix, NULL on error
+ */
+struct ccnl_prefix_s *i3_name_from_published(struct ccnl_prefix_s *published);
+
+/**
+ * @brief   Write a compact name the way the string encoding would read
+ *
+ * Gives /<prefix>/<hwaddr string>/gasval/%04d, so logs stay comparable
+ * between both encodings.
+ */
+char *i3_name_to_str(struct ccnl_prefix_s *name, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* I3_NAME_H */
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/* only linked with -Wl,--wrap=ccnl_ndntlv_bytes2pkt, see the Makefile */
+#ifdef I3_TLV
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "ccnl-pkt-builder.h"
+#include "i3_tlv.h"
+
+/* packets per decoder and type in i3_tlv_bench() */
+#ifndef I3_TLV_BENCH_PACKETS
+#define I3_TLV_BENCH_PACKETS    (10000U)
+#endif
+#define I3_TLV_BENCH_BUFSIZE    (128)
+#define I3_TLV_BENCH_NAME       "/" I3_TLV_PREFIX "/00:00:00:00:00:00:00:01/gasval/0001"
+#define I3_TLV_BENCH_DATA       "{\"id\":\"0x12a77af232\",\"val\":3000}"
+
+/* lengths of 253 and up are followed by a 2, 4 or 8 byte number */
+#define _ONE_BYTE_MAX           (252)
+
+struct ccnl_pkt_s *__real_ccnl_ndntlv_bytes2pkt(unsigned int pkttype,
+                                                unsigned char *start,
+                                                unsigned char **data,
+                                                int *datalen);
+
+/* offsets from the start of the packet */
+typedef struct {
+    int name;
+    int namelen;                /* whole Name TLV */
+    int comp[I3_TLV_COMPS_MAX];
+    int complen[I3_TLV_COMPS_MAX];
+    int compcnt;
+    int content;                /* -1 if none */
+    int contlen;
+    int nonce;                  /* -1 if none */
+    int noncelen;
+    bool has_lifetime;
+    unsigned int lifetime;
+} _layout_t;
+
+static uint32_t _fast, _generic;
+
+/* walks the packet once, -1 if it is not laid out as expected */
+static int _scan(unsigned int pkttype, unsigned char *start,
+                 unsigned char *data, int datalen, _layout_t *l)
+{
+    unsigned char *p = data, *end = data + datalen, *name_end;
+    const int prefix_len = sizeof(I3_TLV_PREFIX) - 1;
+
+    if ((pkttype != NDN_TLV_Interest) && (pkttype != NDN_TLV_Data)) {
+        return -1;
+    }
+    /* both encoders put the name first */
+    if ((end - p < 2) || (p[0] != NDN_TLV_Name) || (p[1] > _ONE_BYTE_MAX) ||
+        (p[1] > end - p - 2)) {
+        return -1;
+    }
+    l->name = p - start;
+    l->namelen = 2 + p[1];
+    name_end = p + l->namelen;
+    l->compcnt = 0;
+    for (p += 2; p < name_end; p += 2 + p[1]) {
+        if ((name_end - p < 2) || (p[0] != NDN_TLV_NameComponent) ||
+            (p[1] > _ONE_BYTE_MAX) || (p[1] > name_end - p - 2) ||
+            (l->compcnt == I3_TLV_COMPS_MAX)) {
+            return -1;
+        }
+        /* CCN-lite takes a leading marker byte for a segment number */
+        if ((p[1] > 0) && (p[2] == NDN_Marker_SegmentNumber)) {
+            return -1;
+        }
+        l->comp[l->compcnt] = p + 2 - start;
+        l->complen[l->compcnt] = p[1];
+        l->compcnt++;
+    }
+    if ((l->compcnt < I3_TLV_COMPS_MIN) || (l->complen[0] != prefix_len) ||
+        memcmp(start + l->comp[0], I3_TLV_PREFIX, prefix_len)) {
+        return -1;
+    }
+
+    l->content = -1;
+    l->nonce = -1;
+    l->has_lifetime = false;
+    for (p = name_end; p < end; p += 2 + p[1]) {
+        if ((end - p < 2) || (p[0] > _ONE_BYTE_MAX) ||
+            (p[1] > _ONE_BYTE_MAX) || (p[1] > end - p - 2)) {
+            return -1;
+        }
+        if (pkttype == NDN_TLV_Interest) {
+            switch (p[0]) {
+                case NDN_TLV_Nonce:
+                    l->nonce = p + 2 - start;
+                    l->noncelen = p[1];
+                    break;
+                case NDN_TLV_InterestLifetime:
+                    if ((p[1] != 1) && (p[1] != 2) && (p[1] != 4)) {
+                        return -1;
+                    }
+                    l->lifetime = 0;
+                    for (int i = 0; i < p[1]; i++) {
+                        l->lifetime = (l->lifetime << 8) | p[2 + i];
+                    }
+                    l->has_lifetime = true;
+                    break;
+                default:
+                    return -1;
+            }
+        }
+        else {
+            switch (p[0]) {
+                case NDN_TLV_Content:
+                    l->content = p + 2 - start;
+                    l->contlen = p[1];
+                    break;
+                /* always encoded, empty unless it holds a FinalBlockId */
+                case NDN_TLV_MetaInfo:
+                    if (p[1] != 0) {
+                        return -1;
+                    }
+                    break;
+                /* not verified by CCN-lite without USE_HMAC256 */
+                case NDN_TLV_SignatureInfo:
+                case NDN_TLV_SignatureValue:
+                    break;
+                default:
+                    return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static struct ccnl_pkt_s *_build(unsigned int pkttype, unsigned char *start,
+                                 int len, _layout_t *l)
+{
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(*pkt));
+    struct ccnl_prefix_s *p;
+
+    if (!pkt) {
+        return NULL;
+    }
+    pkt->type = pkttype;
+    pkt->suite = CCNL_SUITE_NDNTLV;
+    pkt->flags = (pkttype == NDN_TLV_Interest) ? CCNL_PKT_REQUEST
+                                               : CCNL_PKT_REPLY;
+    pkt->s.ndntlv.scope = 3;
+    pkt->s.ndntlv.maxsuffix = CCNL_MAX_NAME_COMP;
+    pkt->s.ndntlv.interestlifetime = l->has_lifetime
+                                     ? l->lifetime
+                                     : CCNL_INTEREST_TIMEOUT * 1000;
+    pkt->val.final_block_id = -1;
+
+    pkt->buf = ccnl_buf_new(start, len);
+    p = ccnl_prefix_new(CCNL_SUITE_NDNTLV, CCNL_MAX_NAME_COMP);
+    pkt->pfx = p;
+    if (!pkt->buf || !p) {
+        goto err;
+    }
+    p->compcnt = l->compcnt;
+    for (int i = 0; i < l->compcnt; i++) {
+        p->comp[i] = pkt->buf->data + l->comp[i];
+        p->complen[i] = l->complen[i];
+    }
+    p->nameptr = pkt->buf->data + l->name;
+    p->namelen = l->namelen;
+    if (l->content >= 0) {
+        pkt->content = pkt->buf->data + l->content;
+        pkt->contlen = l->contlen;
+    }
+    if (l->nonce >= 0) {
+        pkt->s.ndntlv.nonce = ccnl_buf_new(pkt->buf->data + l->nonce,
+                                           l->noncelen);
+        if (!pkt->s.ndntlv.nonce) {
+            goto err;
+        }
+    }
+    return pkt;
+
+err:
+    ccnl_pkt_free(pkt);
+    return NULL;
+}
+
+/* NULL and *@p data untouched if the packet is not for the fast path */
+static struct ccnl_pkt_s *_decode(unsigned int pkttype, unsigned char *start,
+                                  unsigned char **data, int *datalen,
+                                  bool *taken)
+{
+    _layout_t l;
+    struct ccnl_pkt_s *pkt;
+
+    *taken = (*datalen > 0) &&
+             (_scan(pkttype, start, *data, *datalen, &l) == 0);
+    if (!*taken) {
+        return NULL;
+    }
+    pkt = _build(pkttype, start, (*data - start) + *datalen, &l);
+    *data += *datalen;
+    *datalen = 0;
+    return pkt;
+}
+
+struct ccnl_pkt_s *__wrap_ccnl_ndntlv_bytes2pkt(unsigned int pkttype,
+                                                unsigned char *start,
+                                                unsigned char **data,
+                                                int *datalen)
+{
+    bool taken;
+    struct ccnl_pkt_s *pkt = _decode(pkttype, start, data, datalen, &taken);
+
+    if (taken) {
+        _fast++;
+        return pkt;
+    }
+    _generic++;
+    return __real_ccnl_ndntlv_bytes2pkt(pkttype, start, data, datalen);
+}
+
+int i3_tlv_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        _fast = 0;
+        _generic = 0;
+        return 0;
+    }
+    uint32_t total = _fast + _generic;
+
+    /* TLV;<fast>;<generic>;<fast %> */
+    printf("TLV;%lu;%lu;%lu\n", (unsigned long)_fast, (unsigned long)_generic,
+           (unsigned long)(total ? (100 * (uint64_t)_fast) / total : 0));
+    return 0;
+}
+
+static bool _same_buf(struct ccnl_buf_s *a, struct ccnl_buf_s *b)
+{
+    if (!a || !b) {
+        return a == b;
+    }
+    return (a->datalen == b->datalen) && !memcmp(a->data, b->data, a->datalen);
+}
+
+static bool _same(struct ccnl_pkt_s *a, struct ccnl_pkt_s *b)
+{
+    if (!a || !b || (a->type != b->type) || (a->flags != b->flags) ||
+        (a->contlen != b->contlen) ||
+        (a->s.ndntlv.interestlifetime != b->s.ndntlv.interestlifetime) ||
+        (a->s.ndntlv.scope != b->s.ndntlv.scope) ||
+        (a->s.ndntlv.maxsuffix != b->s.ndntlv.maxsuffix) ||
+        (a->val.final_block_id != b->val.final_block_id) ||
+        !_same_buf(a->buf, b->buf) || !_same_buf(a->s.ndntlv.nonce,
+                                                 b->s.ndntlv.nonce) ||
+        ((a->content - a->buf->data) != (b->content - b->buf->data))) {
+        return false;
+    }
+    return !ccnl_prefix_cmp(a->pfx, NULL, b->pfx, CMP_EXACT);
+}
+
+static void _bench(const char *type, unsigned char *pkt, int len,
+                   unsigned packets)
+{
+    struct ccnl_pkt_s *generic = NULL, *fast = NULL;
+    unsigned char *data;
+    int datalen, typ, vallen;
+    bool taken = false;
+    uint32_t start, usec;
+
+    for (int fast_path = 0; fast_path < 2; fast_path++) {
+        start = xtimer_now_usec();
+        for (unsigned i = 0; i < packets; i++) {
+            struct ccnl_pkt_s *p;
+
+            data = pkt;
+            datalen = len;
+            if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &vallen)) {
+                return;
+            }
+            p = fast_path ? _decode(typ, pkt, &data, &datalen, &taken)
+                          : __real_ccnl_ndntlv_bytes2pkt(typ, pkt, &data,
+                                                         &datalen);
+            if (i == 0) {
+                if (fast_path) {
+                    fast = p;
+                }
+                else {
+                    generic = p;
+                }
+            }
+            else if (p) {
+                ccnl_pkt_free(p);
+            }
+        }
+        usec = xtimer_now_usec() - start;
+        /* TLVBENCH;<type>;<decoder>;<packets>;<usec>;<packets/s> */
+        printf("TLVBENCH;%s;%s;%u;%lu;%lu\n", type,
+               fast_path ? "fast" : "generic", packets, (unsigned long)usec,
+               (unsigned long)(((uint64_t)packets * US_PER_SEC) /
+                               (usec ? usec : 1)));
+    }
+    if (!taken) {
+        printf("TLVBENCH;%s;not taken by the fast path\n", type);
+    }
+    else if (!_same(generic, fast)) {
+        printf("TLVBENCH;%s;mismatch\n", type);
+    }
+    if (generic) {
+        ccnl_pkt_free(generic);
+    }
+    if (fast) {
+        ccnl_pkt_free(fast);
+    }
+}
+
+int i3_tlv_bench(int argc, char **argv)
+{
+    unsigned char out[I3_TLV_BENCH_BUFSIZE];
+    unsigned packets = I3_TLV_BENCH_PACKETS;
+    ccnl_interest_opts_u int_opts;
+    struct ccnl_prefix_s *name;
+    struct ccnl_buf_s *interest;
+    int offs = sizeof(out), len;
+
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n <= 0) {
+            printf("usage: %s [packets]\n", argv[0]);
+            return 1;
+        }
+        packets = n;
+    }
+    name = ccnl_URItoPrefix(I3_TLV_BENCH_NAME, CCNL_SUITE_NDNTLV, NULL, NULL);
+    if (!name) {
+        puts("TLVBENCH;out of memory");
+        return 1;
+    }
+    memset(&int_opts, 0, sizeof(int_opts));
+    int_opts.ndntlv.nonce = 0x12345678;
+    int_opts.ndntlv.interestlifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+    interest = ccnl_mkSimpleInterest(name, &int_opts);
+    len = ccnl_ndntlv_prependContent(name, (unsigned char *)I3_TLV_BENCH_DATA,
+                                     sizeof(I3_TLV_BENCH_DATA) - 1, NULL, NULL,
+                                     &offs, out);
+    ccnl_prefix_free(name);
+    if (!interest || (len <= 0)) {
+        puts("TLVBENCH;cannot encode");
+        ccnl_free(interest);
+        return 1;
+    }
+    _bench("interest", interest->data, interest->datalen, packets);
+    _bench("data", out + offs, len, packets);
+    ccnl_free(interest);
+    return 0;
+}
+
+#endif /* I3_TLV */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Link-layer unicast and broadcast counters
+ *
+ * Reads the netstats_l2 counters of the interface CCN-lite is attached to,
+ * relative to the last reset. Every frame sent to a neighbour's address
+ * counts as unicast, every frame sent to the broadcast address as
+ * multicast. The multicast frames are the ones each neighbour has to
+ * receive and process.
+ *
+ * @}
+ */
+
+#ifndef L2_STATS_H
+#define L2_STATS_H
+
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Use the counters of @p netif
+ */
+void l2_stats_init(kernel_pid_t netif);
+
+/**
+ * @brief   Shell command printing the frames sent and received since the
+ *          last reset, "reset" clears them
+ */
+int l2_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* L2_STATS_H */
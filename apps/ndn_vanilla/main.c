@@ -18,18 +18,68 @@
 #include "net/gnrc/pktdump.h"
 #include "pktcnt.h"
 #include "xtimer.h"
+#include "irq.h"
 
 #include "ccn-lite-riot.h"
 #include "ccnl-pkt-builder.h"
 #include "net/hopp/hopp.h"
 
+#ifdef FIB_INDEX
+#include "fib_idx.h"
+#endif
+#ifdef FIB_POOL
+#include "fib_pfx.h"
+#endif
+#ifdef PIT_STATS
+#include "pit_stats.h"
+#endif
+#ifdef CS_POLICY
+#include "cs_policy.h"
+#endif
+#ifdef CCNL_POOLS
+#include "ccnl_pool.h"
+#endif
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef I3_TLV
+#include "i3_tlv.h"
+#endif
+#ifdef RELAY_Q
+#include "relay_q.h"
+#endif
+#ifdef LINK_LQ
+#include "link_lq.h"
+#endif
+#ifdef L2_STATS
+#include "l2_stats.h"
+#endif
+#include "i3_name.h"
+#include "ndn_tmpl.h"
+#ifdef CONSUMER_PIPELINE
+#include "pipeline.h"
+#endif
+#ifdef REQ_SCHED
+#include "req_sched.h"
+#endif
+#ifdef NACK
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+#include "nack.h"
+#endif
+
 /* main thread's message queue */
 #define MAIN_QUEUE_SIZE     (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
 #ifdef MODULE_TLSF
 /* 40kB buffer for the heap should be enough for everyone */
+#ifdef CCNL_POOLS
+/* the pools take their memory from the heap */
+#define TLSF_BUFFER     ((40 * 1024 - CCNL_POOL_BYTES) / sizeof(uint32_t))
+#else
 #define TLSF_BUFFER     ((40 * 1024)/ sizeof(uint32_t))
+#endif
 static uint32_t _tlsf_heap[TLSF_BUFFER];
 #endif
 
@@ -66,9 +116,49 @@ static uint32_t _tlsf_heap[TLSF_BUFFER];
 #define HOPP_PRIO (HOPP_PRIO - 3)
 #endif
 
+#ifndef INT_TMPL_NUMOF
+#define INT_TMPL_NUMOF          (50)
+#endif
+
+#ifndef PROD_BENCH_NUMOF
+#define PROD_BENCH_NUMOF        (100u)
+#endif
+
+#ifdef PREFETCH
+/* number of sequence numbers built ahead of the last one served */
+#ifndef PREFETCH_DEPTH
+#define PREFETCH_DEPTH          (2)
+#endif
+
+/* below every thread doing network work */
+#ifndef PREFETCH_PRIO
+#define PREFETCH_PRIO           (THREAD_PRIORITY_MAIN + 1)
+#endif
+
+#ifndef PREFETCH_STACKSIZE
+#define PREFETCH_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+#define PREFETCH_QUEUE_SIZE     (4)
+#define PREFETCH_BUFSIZE        (128)
+#define PREFETCH_MSG            (0x5046)
+#endif
+
+/* 127 byte 802.15.4 frame minus a MAC header with long addresses and FCS */
+#ifndef L2_PAYLOAD_MAX
+#define L2_PAYLOAD_MAX          (104)
+#endif
+
 uint8_t my_hwaddr[GNRC_NETIF_L2ADDR_MAXLEN];
+size_t my_hwaddr_len;
 char my_hwaddr_str[GNRC_NETIF_L2ADDR_MAXLEN * 3];
 static unsigned char _out[CCNL_MAX_PACKET_SIZE];
+#ifdef DATA_TEMPLATE
+static ndn_tmpl_t _data_tmpl;
+#endif
+#ifdef CONSUMER_PIPELINE
+static char _my_tag[PIPELINE_TAG_LEN + 1];
+#endif
 
 bool i_am_root = false;
 bool hopp_active;
@@ -87,35 +177,272 @@ static uint32_t _count_fib_entries(void) {
     return num_fib_entries;
 }
 
-void *_consumer_event_loop(void *arg)
+#ifdef INTEREST_TEMPLATE
+typedef struct {
+    struct ccnl_forward_s *fwd;
+    ndn_tmpl_t tmpl;
+} _int_tmpl_t;
+
+static _int_tmpl_t _int_tmpl[INT_TMPL_NUMOF];
+static unsigned _int_tmpl_num;
+
+/* pre-encode one Interest per FIB entry */
+static void _int_tmpl_init(void)
+{
+    struct ccnl_forward_s *fwd;
+
+    _int_tmpl_num = 0;
+    for (fwd = ccnl_relay.fib; fwd && (_int_tmpl_num < INT_TMPL_NUMOF);
+         fwd = fwd->next) {
+        _int_tmpl_t *t = &_int_tmpl[_int_tmpl_num];
+        if (ndn_tmpl_interest_init(&t->tmpl, fwd->prefix) < 0) {
+            puts("ERROR building interest template");
+            break;
+        }
+        t->fwd = fwd;
+        _int_tmpl_num++;
+    }
+}
+
+static void _int_tmpl_free(void)
+{
+    for (unsigned i = 0; i < _int_tmpl_num; i++) {
+        ndn_tmpl_free(&_int_tmpl[i].tmpl);
+    }
+    _int_tmpl_num = 0;
+}
+#endif
+
+#ifdef MODULE_PKTCNT_FAST
+static void _print_pub(const char *req_uri, uint64_t now)
+{
+    printf("PUB;%s;%lu%06lu\n", req_uri,
+        (unsigned long)div_u64_by_1000000(now),
+        (unsigned long)now % US_PER_SEC);
+}
+#endif
+
+static void _send_interest(struct ccnl_forward_s *fwd, unsigned fwd_idx,
+                           unsigned seq)
 {
-    (void)arg;
-    /* periodically request content items */
     char req_uri[40];
+#ifndef COMPACT_NAMES
     char *a[2];
     char s[CCNL_MAX_PREFIX_SIZE];
+#endif
+#ifdef MODULE_PKTCNT_FAST
+    uint64_t now = xtimer_now_usec64();
+#endif
+
+#ifdef INTEREST_TEMPLATE
+    /* the FIB only changes if a producer publishes late, so the template
+     * at the entry's position normally is the right one */
+    if ((fwd_idx < _int_tmpl_num) && (_int_tmpl[fwd_idx].fwd == fwd) &&
+        (ndn_tmpl_interest_send(&_int_tmpl[fwd_idx].tmpl, seq) == 0)) {
+#ifdef MODULE_PKTCNT_FAST
+        ndn_tmpl_name_to_str(&_int_tmpl[fwd_idx].tmpl, req_uri, sizeof(req_uri));
+        _print_pub(req_uri, now);
+#endif
+        return;
+    }
+#else
+    (void)fwd_idx;
+#endif
+#ifdef COMPACT_NAMES
+    /* the FIB holds /PREFIX/<hwaddr bytes>, see cb_published() */
+    static unsigned char int_buf[CCNL_MAX_PACKET_SIZE];
+    ccnl_interest_opts_u int_opts;
+    struct ccnl_prefix_s *name = ccnl_prefix_dup(fwd->prefix);
+    (void)req_uri;
+    if (!name) {
+        puts("ERROR building compact name");
+        return;
+    }
+    if (i3_name_append_seq(name, seq) == 0) {
+#ifdef MODULE_PKTCNT_FAST
+        _print_pub(i3_name_to_str(name, req_uri, sizeof(req_uri)), now);
+#endif
+        memset(&int_opts, 0, sizeof(int_opts));
+        int_opts.ndntlv.nonce = random_uint32();
+        int_opts.ndntlv.interestlifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+        ccnl_send_interest(name, int_buf, sizeof(int_buf), &int_opts);
+    }
+    ccnl_prefix_free(name);
+#else
+    ccnl_prefix_to_str(fwd->prefix,s,CCNL_MAX_PREFIX_SIZE);
+    /* s consists of PREFIX and hwaddr as it comes from the fib */
+    snprintf(req_uri, 40, "%s/gasval/%04u", s, seq);
+#ifdef MODULE_PKTCNT_FAST
+    _print_pub(req_uri, now);
+#endif
+    a[1]= req_uri;
+    _ccnl_interest(2, (char **)a);
+#endif
+}
+
+#ifdef NACK
+/* rounds a producer is not requested after a NoRoute NACK */
+#ifndef NACK_HOLDOFF
+#define NACK_HOLDOFF            (8)
+#endif
+
+#define NACK_PRODUCER_NUMOF     (50)
+#define NACK_QUEUE_SIZE         (8)
+
+static msg_t _nack_queue[NACK_QUEUE_SIZE];
+static uint8_t _nack_holdoff[NACK_PRODUCER_NUMOF];
+static bool _nack_congested;
+
+/* take the NACKs handed up since the last request, Data is ignored */
+static void _nack_drain(void)
+{
+    msg_t msg;
+
+    while (msg_try_receive(&msg) == 1) {
+        if (msg.type != GNRC_NETAPI_MSG_TYPE_RCV) {
+            continue;
+        }
+        gnrc_pktsnip_t *pkt = msg.content.ptr;
+        const unsigned char *id, *seq;
+        size_t id_len, seq_len;
+        unsigned fwd_idx = 0;
+
+        switch (nack_parse(pkt->data, pkt->size, &id, &id_len, &seq, &seq_len)) {
+            case NACK_NO_ROUTE:
+                for (struct ccnl_forward_s *fwd = ccnl_relay.fib;
+                     fwd && (fwd_idx < NACK_PRODUCER_NUMOF);
+                     fwd = fwd->next, fwd_idx++) {
+                    if ((fwd->prefix->compcnt > 1) &&
+                        (fwd->prefix->complen[1] == (int)id_len) &&
+                        !memcmp(fwd->prefix->comp[1], id, id_len)) {
+                        _nack_holdoff[fwd_idx] = NACK_HOLDOFF;
+                        break;
+                    }
+                }
+                break;
+            case NACK_CONGESTION:
+                _nack_congested = true;
+                break;
+            default:
+                break;
+        }
+        gnrc_pktbuf_release(pkt);
+    }
+}
+#endif
+
+void *_consumer_event_loop(void *arg)
+{
+    (void)arg;
+    /* periodically request content items */
     struct ccnl_forward_s *fwd;
     int nodes_num = _count_fib_entries();
     uint32_t delay = 0;
+#ifdef NACK
+    gnrc_netreg_entry_t ne = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                        sched_active_pid);
+
+    msg_init_queue(_nack_queue, NACK_QUEUE_SIZE);
+    gnrc_netreg_register(GNRC_NETTYPE_CCN_CHUNK, &ne);
+#endif
+#ifdef INTEREST_TEMPLATE
+    _int_tmpl_init();
+#endif
     for (unsigned i=0; i<NUM_REQUESTS_NODE; i++) {
-        for (fwd = ccnl_relay.fib; fwd; fwd = fwd->next) {
+        unsigned fwd_idx = 0;
+        for (fwd = ccnl_relay.fib; fwd; fwd = fwd->next, fwd_idx++) {
             delay = (uint32_t)((float)REQ_DELAY/(float)nodes_num);
+#ifdef NACK
+            /* back off for one more request slot on congestion */
+            _nack_drain();
+            if (_nack_congested) {
+                _nack_congested = false;
+                delay *= 2;
+            }
+            xtimer_usleep(delay);
+            /* no route to the producer, spare the radio for a while */
+            if ((fwd_idx < NACK_PRODUCER_NUMOF) && _nack_holdoff[fwd_idx]) {
+                _nack_holdoff[fwd_idx]--;
+                continue;
+            }
+#else
             xtimer_usleep(delay);
-            ccnl_prefix_to_str(fwd->prefix,s,CCNL_MAX_PREFIX_SIZE);
-            /* s consists of PREFIX and hwaddr as it comes from the fib */
-            snprintf(req_uri, 40, "%s/gasval/%04d", s, i);
-#ifdef MODULE_PKTCNT_FAST
-            uint64_t now = xtimer_now_usec64();
-            printf("PUB;%s;%lu%06lu\n", req_uri,
-                (unsigned long)div_u64_by_1000000(now),
-                (unsigned long)now % US_PER_SEC);
 #endif
-            a[1]= req_uri;
-            _ccnl_interest(2, (char **)a);
+            _send_interest(fwd, fwd_idx, i);
         }
     }
+#ifdef INTEREST_TEMPLATE
+    _int_tmpl_free();
+#endif
+#ifdef NACK
+    gnrc_netreg_unregister(GNRC_NETTYPE_CCN_CHUNK, &ne);
+#endif
+    return 0;
+}
+
+#ifdef REQ_SCHED
+/* FIB snapshot, producers publishing after req_start are not requested */
+static struct ccnl_forward_s *_sched_fwd[REQ_SCHED_NUMOF];
+
+static bool _sched_send(unsigned idx, unsigned count)
+{
+    if (count >= NUM_REQUESTS_NODE) {
+        return false;
+    }
+    _send_interest(_sched_fwd[idx], idx, count);
+    return true;
+}
+
+/* every producer is requested once per REQ_DELAY, as in the serial loop */
+static uint32_t _sched_period(void)
+{
+    return REQ_DELAY;
+}
+
+void *_sched_event_loop(void *arg)
+{
+    (void)arg;
+    struct ccnl_forward_s *fwd;
+    unsigned num = 0;
+
+    for (fwd = ccnl_relay.fib; fwd && (num < REQ_SCHED_NUMOF); fwd = fwd->next) {
+        _sched_fwd[num++] = fwd;
+    }
+#ifdef INTEREST_TEMPLATE
+    _int_tmpl_init();
+#endif
+    req_sched_run(num, _sched_send, _sched_period);
+#ifdef INTEREST_TEMPLATE
+    _int_tmpl_free();
+#endif
     return 0;
 }
+#endif
+
+#if defined(PIT_STATS) || defined(CS_POLICY) || defined(NACK) || \
+    defined(CS_INDEX)
+/* local producer that only samples the relay's tables and never answers,
+ * except with NACKs and, with CS_INDEX, cached content */
+static int _sample_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                            struct ccnl_pkt_s *pkt)
+{
+    (void)from;
+#ifdef PIT_STATS
+    pit_stats_sample(relay, from, pkt);
+#endif
+#ifdef CS_POLICY
+    cs_policy_sample(relay, pkt);
+#endif
+#ifdef NACK
+    nack_check(relay, from, pkt, PREFIX);
+#endif
+#ifdef CS_INDEX
+    return cs_idx_serve(relay, from, pkt);
+#else
+    return 0;
+#endif
+}
+#endif
 
 static int _req_start(int argc, char **argv)
 {
@@ -125,63 +452,333 @@ static int _req_start(int argc, char **argv)
         puts("Warning: pktcnt module not running");
     }
     /* unset local producer function for consumer node */
+#if defined(PIT_STATS) || defined(CS_POLICY) || defined(NACK) || \
+    defined(CS_INDEX)
+    ccnl_set_local_producer(_sample_producer);
+#else
     ccnl_set_local_producer(NULL);
+#endif
     memset(hopp_stack, 0, HOPP_STACKSZ);
+#ifdef CONSUMER_PIPELINE
+    thread_create(hopp_stack, sizeof(hopp_stack),
+                  CONSUMER_THREAD_PRIORITY,
+                  THREAD_CREATE_STACKTEST, pipeline_event_loop,
+                  NULL, "consumer");
+#elif defined(REQ_SCHED)
+    thread_create(hopp_stack, sizeof(hopp_stack),
+                  CONSUMER_THREAD_PRIORITY,
+                  THREAD_CREATE_STACKTEST, _sched_event_loop,
+                  NULL, "consumer");
+#else
     thread_create(hopp_stack, sizeof(hopp_stack),
                   CONSUMER_THREAD_PRIORITY,
                   THREAD_CREATE_STACKTEST, _consumer_event_loop,
                   NULL, "consumer");
+#endif
     return 0;
 }
 
-int produce_cont_and_cache(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt, int id)
+/* the pipelined consumer matches Data to its requests by the payload */
+static int _payload(char *buffer, int id)
 {
-    (void)pkt;
-    char name[40];
-    int offs = CCNL_MAX_PACKET_SIZE;
+#ifdef CONSUMER_PIPELINE
+    return sprintf(buffer, PIPELINE_PAYLOAD_FMT, _my_tag, (unsigned)id);
+#else
+    (void)id;
+    return sprintf(buffer, "%s", I3_DATA);
+#endif
+}
 
-    char buffer[33];
-    int len = sprintf(buffer, "%s", I3_DATA);
-    buffer[len]='\0';
+/* the string name HoPP publishes content item id under */
+static struct ccnl_prefix_s *_uri_name(int id)
+{
+    char name[40];
 
     int name_len = sprintf(name, "/%s/%s/gasval/%04d", PREFIX, my_hwaddr_str, id);
     name[name_len]='\0';
 
-    struct ccnl_prefix_s *prefix = ccnl_URItoPrefix(name, CCNL_SUITE_NDNTLV, NULL, NULL);
+    return ccnl_URItoPrefix(name, CCNL_SUITE_NDNTLV, NULL, NULL);
+}
+
+/* the name the consumer requests content item id by */
+static struct ccnl_prefix_s *_content_name(int id)
+{
+#ifdef COMPACT_NAMES
+    struct ccnl_prefix_s *prefix = i3_name_prefix(PREFIX, my_hwaddr,
+                                                  my_hwaddr_len);
+    if (prefix && (i3_name_append_seq(prefix, id) < 0)) {
+        ccnl_prefix_free(prefix);
+        return NULL;
+    }
+    return prefix;
+#else
+    return _uri_name(id);
+#endif
+}
+
+/* encode the Data for content item id under @p prefix, which is freed */
+static struct ccnl_pkt_s *_encode_pkt(struct ccnl_prefix_s *prefix, int id,
+                                      unsigned char *out, int out_len)
+{
+    int offs = out_len;
+
+    char buffer[33];
+    int len = _payload(buffer, id);
+    buffer[len]='\0';
+
+    if (!prefix) {
+        return NULL;
+    }
     int arg_len = ccnl_ndntlv_prependContent(prefix, (unsigned char*) buffer,
-        len, NULL, NULL, &offs, _out);
+        len, NULL, NULL, &offs, out);
 
     ccnl_prefix_free(prefix);
 
     unsigned char *olddata;
-    unsigned char *data = olddata = _out + offs;
+    unsigned char *data = olddata = out + offs;
 
     unsigned typ;
 
     if (ccnl_ndntlv_dehead(&data, &arg_len, (int*) &typ, &len) || typ != NDN_TLV_Data) {
+        return NULL;
+    }
+
+    return ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &arg_len);
+}
+
+static struct ccnl_pkt_s *_build_pkt(int id, unsigned char *out, int out_len)
+{
+    return _encode_pkt(_content_name(id), id, out, out_len);
+}
+
+static int _data_tmpl_init(ndn_tmpl_t *tmpl)
+{
+    char name[40];
+    char buffer[33];
+    int len = _payload(buffer, 0);
+#ifdef CONSUMER_PIPELINE
+    /* the sequence number closes the payload */
+    int pay_seq_offs = len - 1 - NDN_TMPL_SEQ_WIDTH;
+#else
+    int pay_seq_offs = -1;
+#endif
+
+    sprintf(name, "/%s/%s/gasval/%04d", PREFIX, my_hwaddr_str, 0);
+    return ndn_tmpl_data_init(tmpl, name, (unsigned char *)buffer, len,
+                              pay_seq_offs);
+}
+
+#ifdef PREFETCH
+typedef struct {
+    unsigned seq;
+    struct ccnl_pkt_s *pkt;
+} _prefetch_slot_t;
+
+typedef struct {
+    uint32_t num;
+    uint64_t usec;
+    uint32_t max;
+} _prefetch_lat_t;
+
+static _prefetch_slot_t _prefetch[PREFETCH_DEPTH];
+static kernel_pid_t _prefetch_pid = KERNEL_PID_UNDEF;
+static char _prefetch_stack[PREFETCH_STACKSIZE];
+static msg_t _prefetch_queue[PREFETCH_QUEUE_SIZE];
+static _prefetch_lat_t _prefetch_hit, _prefetch_miss;
+static uint32_t _prefetch_built, _prefetch_dropped;
+
+/* hand a pre-built packet to the relay thread, NULL if seq was not built */
+static struct ccnl_pkt_s *_prefetch_take(unsigned seq)
+{
+    _prefetch_slot_t *slot = &_prefetch[seq % PREFETCH_DEPTH];
+    struct ccnl_pkt_s *pk = NULL;
+    unsigned state = irq_disable();
+
+    if (slot->pkt && (slot->seq == seq)) {
+        pk = slot->pkt;
+        slot->pkt = NULL;
+    }
+    irq_restore(state);
+    return pk;
+}
+
+static void _prefetch_put(unsigned seq, struct ccnl_pkt_s *pk)
+{
+    _prefetch_slot_t *slot = &_prefetch[seq % PREFETCH_DEPTH];
+    struct ccnl_pkt_s *old;
+    unsigned state = irq_disable();
+
+    /* an older sequence number nobody asked for */
+    old = slot->pkt;
+    slot->seq = seq;
+    slot->pkt = pk;
+    irq_restore(state);
+    if (old) {
+        ccnl_pkt_free(old);
+    }
+}
+
+static bool _prefetch_has(unsigned seq)
+{
+    _prefetch_slot_t *slot = &_prefetch[seq % PREFETCH_DEPTH];
+    unsigned state = irq_disable();
+    bool res = slot->pkt && (slot->seq == seq);
+
+    irq_restore(state);
+    return res;
+}
+
+static void _prefetch_lat(_prefetch_lat_t *lat, uint32_t usec)
+{
+    lat->num++;
+    lat->usec += usec;
+    if (usec > lat->max) {
+        lat->max = usec;
+    }
+}
+
+/* builds the sequence numbers following the one just served */
+static void *_prefetch_loop(void *arg)
+{
+    (void)arg;
+    static unsigned char out[PREFETCH_BUFSIZE];
+#ifdef DATA_TEMPLATE
+    /* the relay thread patches _data_tmpl concurrently */
+    static ndn_tmpl_t tmpl;
+    bool have_tmpl = (_data_tmpl_init(&tmpl) == 0);
+#endif
+
+    msg_init_queue(_prefetch_queue, PREFETCH_QUEUE_SIZE);
+    while (1) {
+        msg_t m;
+        msg_receive(&m);
+        if (m.type != PREFETCH_MSG) {
+            continue;
+        }
+        for (unsigned seq = m.content.value + 1;
+             (seq <= m.content.value + PREFETCH_DEPTH) && (seq < NUM_REQUESTS_NODE);
+             seq++) {
+            struct ccnl_pkt_s *pk = NULL;
+
+            if (_prefetch_has(seq)) {
+                continue;
+            }
+#ifdef DATA_TEMPLATE
+            if (have_tmpl) {
+                pk = ndn_tmpl_pkt(&tmpl, seq);
+            }
+#endif
+            if (!pk) {
+                pk = _build_pkt(seq, out, sizeof(out));
+            }
+            if (pk) {
+                _prefetch_put(seq, pk);
+                _prefetch_built++;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int _prefetch_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_prefetch_hit, 0, sizeof(_prefetch_hit));
+        memset(&_prefetch_miss, 0, sizeof(_prefetch_miss));
+        _prefetch_built = 0;
+        _prefetch_dropped = 0;
+        return 0;
+    }
+    /* PREFETCH;<depth>;<hits>;<avg us>;<max us>;<misses>;<avg us>;<max us>;
+     *          <built>;<dropped> */
+    printf("PREFETCH;%u;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n", PREFETCH_DEPTH,
+           (unsigned long)_prefetch_hit.num,
+           (unsigned long)(_prefetch_hit.num ? _prefetch_hit.usec / _prefetch_hit.num : 0),
+           (unsigned long)_prefetch_hit.max,
+           (unsigned long)_prefetch_miss.num,
+           (unsigned long)(_prefetch_miss.num ? _prefetch_miss.usec / _prefetch_miss.num : 0),
+           (unsigned long)_prefetch_miss.max,
+           (unsigned long)_prefetch_built, (unsigned long)_prefetch_dropped);
+    return 0;
+}
+#endif
+
+int produce_cont_and_cache(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt, int id)
+{
+    (void)pkt;
+    struct ccnl_pkt_s *pk = NULL;
+
+#ifdef PREFETCH
+    uint32_t start = xtimer_now_usec();
+    pk = _prefetch_take(id);
+    bool prefetched = (pk != NULL);
+#endif
+#ifdef DATA_TEMPLATE
+    /* only patch the sequence number, fall back for ids beyond %04d */
+    if (!pk) {
+        pk = ndn_tmpl_pkt(&_data_tmpl, id);
+    }
+#endif
+    if (!pk) {
+        pk = _build_pkt(id, _out, sizeof(_out));
+    }
+    if (!pk) {
         puts("ERROR in producer_func");
         return -1;
     }
 
     struct ccnl_content_s *c = 0;
-    struct ccnl_pkt_s *pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &arg_len);
     c = ccnl_content_new(&pk);
     ccnl_content_add2cache(relay, c);
+#ifdef PREFETCH
+    _prefetch_lat(prefetched ? &_prefetch_hit : &_prefetch_miss,
+                  xtimer_now_usec() - start);
+    /* never block the relay, a dropped request only costs a miss later */
+    msg_t m = { .type = PREFETCH_MSG, .content.value = id };
+    if ((_prefetch_pid == KERNEL_PID_UNDEF) || (msg_try_send(&m, _prefetch_pid) < 1)) {
+        _prefetch_dropped++;
+    }
+#endif
     return 0;
 }
 
 int producer_func(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_pkt_s *pkt){
     (void)from;
+#ifdef PIT_STATS
+    pit_stats_sample(relay, from, pkt);
+#endif
+#ifdef CS_POLICY
+    cs_policy_sample(relay, pkt);
+#endif
     if(pkt->pfx->compcnt == 4) { /* /PREFIX/ID/gasval/<value> */
+#ifdef COMPACT_NAMES
+        /* ID is the raw hwaddr, value a nonNegativeInteger */
+        uint32_t id;
+        if (!memcmp(pkt->pfx->comp[0], PREFIX, pkt->pfx->complen[0]) &&
+            (pkt->pfx->complen[1] == (int)my_hwaddr_len) &&
+            !memcmp(pkt->pfx->comp[1], my_hwaddr, my_hwaddr_len) &&
+            !memcmp(pkt->pfx->comp[2], "gasval", pkt->pfx->complen[2]) &&
+            !i3_name_seq_decode(pkt->pfx->comp[3], pkt->pfx->complen[3], &id)) {
+            return produce_cont_and_cache(relay, pkt, id);
+        }
+#else
         /* match PREFIX and ID and "gasval" */
         if (!memcmp(pkt->pfx->comp[0], PREFIX, pkt->pfx->complen[0]) &&
             !memcmp(pkt->pfx->comp[1], my_hwaddr_str, pkt->pfx->complen[1]) &&
             !memcmp(pkt->pfx->comp[2], "gasval", pkt->pfx->complen[2])) {
             return produce_cont_and_cache(relay, pkt, atoi((const char *)pkt->pfx->comp[3]));
         }
+#endif
     }
+#ifdef NACK
+    nack_check(relay, from, pkt, PREFIX);
+#endif
+#ifdef CS_INDEX
+    return cs_idx_serve(relay, from, pkt);
+#else
     return 0;
+#endif
 }
 
 static int _root(int argc, char **argv)
@@ -215,6 +812,58 @@ static int _hopp_end(int argc, char **argv) {
     return 0;
 }
 
+#ifdef FIB_POOL
+static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                         struct ccnl_face_s *from)
+{
+    struct ccnl_prefix_s *name = pkt->pfx;
+    struct ccnl_forward_s *fwd;
+#ifdef COMPACT_NAMES
+    uint8_t hwaddr[GNRC_NETIF_L2ADDR_MAXLEN];
+    unsigned char *comp[2];
+    int complen[2];
+    struct ccnl_prefix_s compact;
+#endif
+
+    printf("PUBLISHED: /%.*s/%.*s\n", name->complen[0], name->comp[0],
+                                      name->complen[1], name->comp[1]);
+#ifdef COMPACT_NAMES
+    /* HoPP publishes the hwaddr string, the FIB gets its bytes */
+    comp[0] = name->comp[0];
+    complen[0] = name->complen[0];
+    comp[1] = hwaddr;
+    complen[1] = i3_name_hwaddr(name, hwaddr);
+    if (!complen[1]) {
+        puts("ERROR building compact name");
+        return;
+    }
+    memset(&compact, 0, sizeof(compact));
+    compact.comp = comp;
+    compact.complen = complen;
+    compact.compcnt = 2;
+    compact.suite = name->suite;
+    name = &compact;
+#endif
+#ifdef FIB_INDEX
+    fwd = fib_idx_find(&fib_idx, name, 2);
+#else
+    fwd = fib_pfx_find(name, 2);
+#endif
+    from->flags |= CCNL_FACE_FLAGS_STATIC;
+    if (fwd) {
+        /* republished prefix, only its face may have changed */
+        fwd->face = from;
+        return;
+    }
+    if (!fib_pfx_add(relay, name, 2, from)) {
+        puts("FIB FULL");
+        return;
+    }
+#ifdef FIB_INDEX
+    fib_idx_sync(&fib_idx, relay->fib);
+#endif
+}
+#else
 static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
                          struct ccnl_face_s *from)
 {
@@ -226,15 +875,42 @@ static void cb_published(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
              "/%.*s/%.*s", pkt->pfx->complen[0], pkt->pfx->comp[0],
                            pkt->pfx->complen[1], pkt->pfx->comp[1]);
     printf("PUBLISHED: %s\n", scratch);
-    prefix = ccnl_URItoPrefix(scratch, CCNL_SUITE_NDNTLV, NULL, NULL);
+#ifdef COMPACT_NAMES
+    /* HoPP publishes the hwaddr string, the FIB gets its bytes */
+    prefix = i3_name_from_published(pkt->pfx);
+#else
+    prefix = NULL;
+#endif
+#ifdef FIB_INDEX
+    /* republished prefix, only its face may have changed */
+    struct ccnl_forward_s *fwd = fib_idx_find(&fib_idx,
+                                              prefix ? prefix : pkt->pfx, 2);
+    if (fwd) {
+        from->flags |= CCNL_FACE_FLAGS_STATIC;
+        fwd->face = from;
+        if (prefix) {
+            ccnl_prefix_free(prefix);
+        }
+        return;
+    }
+#endif
+    if (!prefix) {
+        prefix = ccnl_URItoPrefix(scratch, CCNL_SUITE_NDNTLV, NULL, NULL);
+    }
 
     from->flags |= CCNL_FACE_FLAGS_STATIC;
     int ret = ccnl_fib_add_entry(relay, ccnl_prefix_dup(prefix), from);
     if (ret != 0) {
         puts("FIB FULL");
     }
+#ifdef FIB_INDEX
+    else {
+        fib_idx_sync(&fib_idx, relay->fib);
+    }
+#endif
     ccnl_prefix_free(prefix);
 }
+#endif
 
 static int _publish(int argc, char **argv)
 {
@@ -278,11 +954,166 @@ static int _pktcnt_start(int argc, char **argv) {
 }
 #endif
 
+/* template if given, else the string name with @p uri, else the name the
+ * consumer requests */
+static uint32_t _bench_pkts(ndn_tmpl_t *tmpl, bool uri, unsigned num)
+{
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < num; i++) {
+        struct ccnl_pkt_s *pk;
+
+        if (tmpl) {
+            pk = ndn_tmpl_pkt(tmpl, i);
+        }
+        else if (uri) {
+            pk = _encode_pkt(_uri_name(i), i, _out, sizeof(_out));
+        }
+        else {
+            pk = _build_pkt(i, _out, sizeof(_out));
+        }
+        if (pk) {
+            ccnl_pkt_free(pk);
+        }
+    }
+    return xtimer_now_usec() - start;
+}
+
+static void _bench_print(const char *path, unsigned num, uint32_t usec)
+{
+#ifdef CLOCK_CORECLOCK
+    uint64_t cycles = ((uint64_t)usec * (CLOCK_CORECLOCK / US_PER_SEC)) / num;
+#else
+    uint64_t cycles = 0;
+#endif
+    printf("BENCH;%s;%u;%" PRIu32 ";%lu\n", path, num, usec,
+           (unsigned long)cycles);
+}
+
+/* compare the per-request cost of both producer paths, run on an idle node */
+static int _prod_bench(int argc, char **argv)
+{
+    static ndn_tmpl_t tmpl;
+    unsigned num = (argc > 1) ? (unsigned)atoi(argv[1]) : PROD_BENCH_NUMOF;
+
+    if ((num == 0) || (num > NDN_TMPL_SEQ_MAX + 1)) {
+        printf("usage: %s [1-%u]\n", argv[0], NDN_TMPL_SEQ_MAX + 1);
+        return 1;
+    }
+    if (_data_tmpl_init(&tmpl) < 0) {
+        puts("ERROR building data template");
+        return 1;
+    }
+    /* BENCH;<path>;<requests>;<usec total>;<cycles per request> */
+#ifdef COMPACT_NAMES
+    /* the template patches the %04d string name, so "uri" is the baseline
+     * of both: "compact" against it is the name encoding, "tmpl" against it
+     * the templating */
+    _bench_print("compact", num, _bench_pkts(NULL, false, num));
+#endif
+    _bench_print("uri", num, _bench_pkts(NULL, true, num));
+    _bench_print("tmpl", num, _bench_pkts(&tmpl, false, num));
+    ndn_tmpl_free(&tmpl);
+    return 0;
+}
+
+static void _name_size(const char *encoding, struct ccnl_prefix_s *name)
+{
+    static unsigned char buf[CCNL_MAX_PACKET_SIZE];
+    ccnl_interest_opts_u int_opts;
+    struct ccnl_buf_s *interest;
+    int offs = sizeof(buf), name_len = 0, int_len = 0, data_len;
+
+    for (int i = 0; i < name->compcnt; i++) {
+        /* one byte type and length each while components stay short */
+        name_len += 2 + name->complen[i];
+    }
+    memset(&int_opts, 0, sizeof(int_opts));
+    int_opts.ndntlv.interestlifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+    interest = ccnl_mkSimpleInterest(name, &int_opts);
+    if (interest) {
+        int_len = interest->datalen;
+        ccnl_free(interest);
+    }
+    data_len = ccnl_ndntlv_prependContent(name, (unsigned char *)I3_DATA,
+                                          strlen(I3_DATA), NULL, NULL, &offs, buf);
+    /* NAMESIZE;<encoding>;<name>;<interest>;<data>;<l2 payload max> */
+    printf("NAMESIZE;%s;%d;%d;%d;%d\n", encoding, name_len, int_len, data_len,
+           L2_PAYLOAD_MAX);
+}
+
+/* encoded sizes of the highest requested name in both encodings */
+static int _name_sizes(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    char uri[40];
+    unsigned seq = NUM_REQUESTS_NODE - 1;
+    struct ccnl_prefix_s *name;
+
+    snprintf(uri, sizeof(uri), "/%s/%s/gasval/%04u", PREFIX, my_hwaddr_str, seq);
+    name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    if (name) {
+        _name_size("string", name);
+        ccnl_prefix_free(name);
+    }
+    name = i3_name_prefix(PREFIX, my_hwaddr, my_hwaddr_len);
+    if (name && (i3_name_append_seq(name, seq) == 0)) {
+        _name_size("compact", name);
+    }
+    if (name) {
+        ccnl_prefix_free(name);
+    }
+    return 0;
+}
+
 static const shell_command_t shell_commands[] = {
     { "hr", "start HoPP root", _root },
     { "hp", "publish data", _publish },
     { "he", "HoPP end", _hopp_end },
     { "req_start", "start periodic content requests", _req_start },
+    { "prod_bench", "benchmark producer packet encoding", _prod_bench },
+    { "name_sizes", "print encoded name, Interest and Data sizes", _name_sizes },
+#ifdef PREFETCH
+    { "prefetch", "print producer latency with and without prefetching", _prefetch_stats },
+#endif
+#ifdef CONSUMER_PIPELINE
+    { "pipeline", "print per-producer Interest windows", pipeline_stats },
+    { "rto", "print per-producer RTO and Data latencies", pipeline_rto },
+#endif
+#ifdef REQ_SCHED
+    { "sched", "print request scheduling lateness, \"sched reset\" clears it", req_sched_stats },
+#endif
+#ifdef NACK
+    { "nack", "print NACKs sent and received, \"nack reset\" clears them", nack_stats },
+#endif
+#ifdef FIB_INDEX
+    { "fib_bench", "benchmark FIB lookups, list vs. hash index", fib_idx_bench },
+#endif
+#ifdef CS_POLICY
+    { "cs", "print content store counters, \"cs reset\" clears them", cs_policy_stats },
+#endif
+#ifdef PIT_STATS
+    { "pit", "print PIT counters, \"pit reset\" clears them", pit_stats },
+#endif
+#ifdef CCNL_POOLS
+    { "pools", "print CCN-lite pool use, \"pools reset\" clears it", ccnl_pool_stats },
+#endif
+#ifdef CS_INDEX
+    { "cs_bench", "benchmark CS lookups, list vs. hash index", cs_idx_bench },
+#endif
+#ifdef I3_TLV
+    { "tlv", "print packets decoded on the i3 fast path, \"tlv reset\" clears them", i3_tlv_stats },
+    { "tlv_bench", "benchmark NDN-TLV decoding, generic vs. i3 fast path", i3_tlv_bench },
+#endif
+#ifdef RELAY_Q
+    { "relayq", "print received frames queued and dropped per class, \"relayq reset\" clears them", relay_q_stats },
+#endif
+#ifdef LINK_LQ
+    { "link", "print rank changes, delivery ratio and link quality per neighbour, \"link reset\" clears them", link_lq_stats },
+#endif
+#ifdef L2_STATS
+    { "l2", "print link-layer unicast and broadcast frames, \"l2 reset\" clears them", l2_stats },
+#endif
 #ifdef MODULE_PKTCNT_FAST
     { "pktcnt_p", "print variables of pktcnt_fast module", _pktcnt_p },
 #else
@@ -304,17 +1135,43 @@ int main(void)
     ccnl_core_init();
 
     ccnl_start();
+#ifdef CS_POLICY
+    cs_policy_init();
+#endif
+#ifdef NACK
+    nack_init();
+#endif
+#ifdef CS_INDEX
+    cs_idx_attach();
+#endif
 
     /* get the default interface */
     gnrc_netif_t *netif = gnrc_netif_iter(NULL);
 
     gnrc_netapi_set(netif->pid, NETOPT_SRC_LEN, 0, &src_len, sizeof(src_len));
 
-    /* set the relay's PID, configure the interface to use CCN nettype */
+    /* set the relay's PID, configure the interface to use CCN nettype.
+     * CCN-lite copies every received frame into a ccnl_buf_s, whose bytes
+     * are inline, and every packet it sends into a new snip. Both copies
+     * are inside the package's RIOT adaptation, wrapping ccnl_ll_TX() only
+     * sees the finished buffer, so the app cannot remove them. */
     if (ccnl_open_netif(netif->pid, GNRC_NETTYPE_CCN) < 0) {
         puts("Error registering at network interface!");
         return -1;
     }
+#ifdef L2_STATS
+    l2_stats_init(netif->pid);
+#endif
+#ifdef RELAY_Q
+    if (relay_q_init() < 0) {
+        return -1;
+    }
+#endif
+#ifdef LINK_LQ
+    if (link_lq_init(netif->pid) < 0) {
+        return -1;
+    }
+#endif
 
 #ifdef MODULE_GNRC_PKTDUMP
     gnrc_netreg_entry_t dump = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
@@ -325,14 +1182,32 @@ int main(void)
     ccnl_set_local_producer(producer_func);
     /* save hw address globally */
 #ifdef BOARD_NATIVE
-    gnrc_netapi_get(netif->pid, NETOPT_ADDRESS, 0, my_hwaddr, sizeof(my_hwaddr));
+    int res = gnrc_netapi_get(netif->pid, NETOPT_ADDRESS, 0, my_hwaddr, sizeof(my_hwaddr));
 #else
-    gnrc_netapi_get(netif->pid, NETOPT_ADDRESS_LONG, 0, my_hwaddr, sizeof(my_hwaddr));
+    int res = gnrc_netapi_get(netif->pid, NETOPT_ADDRESS_LONG, 0, my_hwaddr, sizeof(my_hwaddr));
 #endif
+    my_hwaddr_len = (res > 0) ? (size_t)res : sizeof(my_hwaddr);
     gnrc_netif_addr_to_str(my_hwaddr, sizeof(my_hwaddr), my_hwaddr_str);
 
     printf("hwaddr: %s\n", my_hwaddr_str);
 
+#ifdef CONSUMER_PIPELINE
+    pipeline_tag(my_hwaddr_str, strlen(my_hwaddr_str), _my_tag);
+#endif
+
+#ifdef DATA_TEMPLATE
+    if (_data_tmpl_init(&_data_tmpl) < 0) {
+        puts("Error building data template!");
+        return -1;
+    }
+#endif
+
+#ifdef PREFETCH
+    _prefetch_pid = thread_create(_prefetch_stack, sizeof(_prefetch_stack),
+                                  PREFETCH_PRIO, THREAD_CREATE_STACKTEST,
+                                  _prefetch_loop, NULL, "prefetch");
+#endif
+
 #ifdef MODULE_HOPP
     hopp_active=true;
     hopp_netif = netif;
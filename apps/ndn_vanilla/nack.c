@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ccnl-pkt-builder.h"
+#ifdef CS_INDEX
+#include "cs_idx.h"
+#endif
+#ifdef FIB_INDEX
+#include "fib_idx.h"
+#endif
+
+#include "nack.h"
+
+#define NACK_PAYLOAD_MAX        (64)
+
+typedef struct {
+    uint32_t no_route;
+    uint32_t congestion;
+    uint32_t duplicate;
+} _counters_t;
+
+static _counters_t _sent, _rcvd;
+static uint32_t _uncached;      /* NACKs received and kept out of the CS */
+
+/* set while _reply() adds its own NACK */
+static bool _replying;
+
+static bool _routed(struct ccnl_relay_s *relay, struct ccnl_prefix_s *name)
+{
+#ifdef FIB_INDEX
+    if (fib_idx_lookup(&fib_idx, name)) {
+        return true;
+    }
+#endif
+    for (struct ccnl_forward_s *fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (ccnl_prefix_cmp(fwd->prefix, NULL, name, CMP_LONGEST) >=
+            fwd->prefix->compcnt) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _cached(struct ccnl_relay_s *relay, struct ccnl_prefix_s *name)
+{
+#ifdef CS_INDEX
+    return cs_idx_lookup(&cs_idx, relay, name) != NULL;
+#else
+    for (struct ccnl_content_s *c = relay->contents; c; c = c->next) {
+        if (!ccnl_prefix_cmp(c->pkt->pfx, NULL, name, CMP_EXACT)) {
+            return true;
+        }
+    }
+    return false;
+#endif
+}
+
+static bool _same_nonce(struct ccnl_pkt_s *a, struct ccnl_pkt_s *b)
+{
+    struct ccnl_buf_s *na = a->s.ndntlv.nonce, *nb = b->s.ndntlv.nonce;
+
+    return na && nb && (na->datalen == nb->datalen) &&
+           !memcmp(na->data, nb->data, na->datalen);
+}
+
+/* NACK_DUPLICATE if the PIT holds the Interest from another face,
+ * NACK_CONGESTION if it is full and holds no Interest of the name */
+static nack_reason_t _pit(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                          struct ccnl_pkt_s *pkt)
+{
+    bool pending = false;
+
+    for (struct ccnl_interest_s *i = relay->pit; i; i = i->next) {
+        if (ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) {
+            continue;
+        }
+        if ((i->from != from) && _same_nonce(i->pkt, pkt)) {
+            return NACK_DUPLICATE;
+        }
+        pending = true;
+    }
+    if (!pending && (relay->max_pit_entries > 0) &&
+        (relay->pitcnt >= relay->max_pit_entries)) {
+        return NACK_CONGESTION;
+    }
+    return NACK_NONE;
+}
+
+static void _reply(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                   nack_reason_t reason)
+{
+    unsigned char buf[NACK_PAYLOAD_MAX];
+    struct ccnl_prefix_s *name = pkt->pfx;
+    struct ccnl_content_s *c;
+    int len = NACK_MAGIC_LEN + 2 + name->complen[1] + name->complen[3];
+
+    if (len > NACK_PAYLOAD_MAX) {
+        return;
+    }
+    memcpy(buf, NACK_MAGIC, NACK_MAGIC_LEN);
+    buf[NACK_MAGIC_LEN] = reason;
+    buf[NACK_MAGIC_LEN + 1] = name->complen[1];
+    memcpy(&buf[NACK_MAGIC_LEN + 2], name->comp[1], name->complen[1]);
+    memcpy(&buf[NACK_MAGIC_LEN + 2 + name->complen[1]], name->comp[3],
+           name->complen[3]);
+    c = ccnl_mkContentObject(name, buf, len, NULL);
+    if (!c) {
+        return;
+    }
+    /* stale right away, so nobody keeps it longer than needed */
+    c->last_used -= CCNL_CONTENT_TIMEOUT + 5;
+    _replying = true;
+    ccnl_content_add2cache(relay, c);
+    _replying = false;
+}
+
+nack_reason_t nack_check(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                         struct ccnl_pkt_s *pkt, const char *prefix)
+{
+    struct ccnl_prefix_s *name = pkt->pfx;
+    nack_reason_t reason;
+
+    /* only content names, HoPP's own Interests are none of our business */
+    if ((name->compcnt != 4) ||
+        (name->complen[0] != (int)strlen(prefix)) ||
+        memcmp(name->comp[0], prefix, name->complen[0]) ||
+        (name->complen[2] != 6) || memcmp(name->comp[2], "gasval", 6)) {
+        return NACK_NONE;
+    }
+    reason = _pit(relay, from, pkt);
+    if (reason == NACK_DUPLICATE) {
+        _sent.duplicate++;
+        return reason;
+    }
+    if (_cached(relay, name)) {
+        return NACK_NONE;
+    }
+    if (reason == NACK_NONE) {
+        if (_routed(relay, name)) {
+            return NACK_NONE;
+        }
+        reason = NACK_NO_ROUTE;
+    }
+    if (reason == NACK_NO_ROUTE) {
+        _sent.no_route++;
+    }
+    else {
+        _sent.congestion++;
+    }
+    _reply(relay, pkt, reason);
+    return reason;
+}
+
+int nack_cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_pkt_s *pkt = c->pkt;
+
+    (void)relay;
+    if (_replying || (pkt->contlen < NACK_MAGIC_LEN + 2) ||
+        memcmp(pkt->content, NACK_MAGIC, NACK_MAGIC_LEN)) {
+        return 1;
+    }
+    _uncached++;
+    return 0;
+}
+
+void nack_init(void)
+{
+#ifndef CS_POLICY
+    ccnl_set_cache_strategy_cache(nack_cache);
+#endif
+}
+
+nack_reason_t nack_parse(const unsigned char *data, size_t len,
+                         const unsigned char **id, size_t *id_len,
+                         const unsigned char **seq, size_t *seq_len)
+{
+    nack_reason_t reason;
+
+    if ((len < NACK_MAGIC_LEN + 2) ||
+        memcmp(data, NACK_MAGIC, NACK_MAGIC_LEN) ||
+        (len < (size_t)NACK_MAGIC_LEN + 2 + data[NACK_MAGIC_LEN + 1])) {
+        return NACK_NONE;
+    }
+    reason = data[NACK_MAGIC_LEN];
+    switch (reason) {
+        case NACK_NO_ROUTE:
+            _rcvd.no_route++;
+            break;
+        case NACK_CONGESTION:
+            _rcvd.congestion++;
+            break;
+        case NACK_DUPLICATE:
+            _rcvd.duplicate++;
+            break;
+        default:
+            return NACK_NONE;
+    }
+    *id = &data[NACK_MAGIC_LEN + 2];
+    *id_len = data[NACK_MAGIC_LEN + 1];
+    *seq = *id + *id_len;
+    *seq_len = len - (NACK_MAGIC_LEN + 2) - *id_len;
+    return reason;
+}
+
+int nack_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_sent, 0, sizeof(_sent));
+        memset(&_rcvd, 0, sizeof(_rcvd));
+        _uncached = 0;
+        return 0;
+    }
+    /* NACK;<sent noroute>;<sent congestion>;<duplicates>;
+     *      <rcvd noroute>;<rcvd congestion>;<rcvd duplicate>;<not cached> */
+    printf("NACK;%lu;%lu;%lu;%lu;%lu;%lu;%lu\n",
+           (unsigned long)_sent.no_route, (unsigned long)_sent.congestion,
+           (unsigned long)_sent.duplicate, (unsigned long)_rcvd.no_route,
+           (unsigned long)_rcvd.congestion, (unsigned long)_rcvd.duplicate,
+           (unsigned long)_uncached);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Interest NACKs for content the relay cannot fetch
+ *
+ * CCN-lite has no NDNLP NACKs, so a relay answers an Interest it cannot
+ * forward with a Data of the Interest's name whose payload carries the
+ * reason (the NDNLP reason codes), the producer name component and the
+ * sequence number component. Like ipush's ACKs the Data is added to the CS
+ * already stale, the relay answers from there and evicts it first.
+ *
+ * Relays on the way back, the consumer's own included, must not cache the
+ * NACK: it carries the real content name, so a retry after the route came
+ * back would get the cached NACK instead of the Data. nack_cache() keeps
+ * every NACK but the relay's own out of the CS.
+ *
+ * A NACK Data satisfies every PIT entry of its name on the way back. For a
+ * looping Interest that would also kill the pending original, so
+ * duplicates are only counted and dropped by CCN-lite as before.
+ *
+ * @}
+ */
+
+#ifndef NACK_H
+#define NACK_H
+
+#include <stddef.h>
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   NACK reasons, NDNLP codes
+ */
+typedef enum {
+    NACK_NONE       = 0,
+    NACK_CONGESTION = 50,
+    NACK_DUPLICATE  = 100,
+    NACK_NO_ROUTE   = 150,
+} nack_reason_t;
+
+/* payload: "NACK" <reason> <id length> <id> <seq> */
+#define NACK_MAGIC              "NACK"
+#define NACK_MAGIC_LEN          (4)
+
+/**
+ * @brief   Keep NACKs received from other relays out of the CS
+ *
+ * Registered as the relay's cache strategy, unless CS_POLICY is set, whose
+ * strategy asks it instead.
+ */
+void nack_init(void);
+
+/**
+ * @brief   Cache strategy refusing received NACKs
+ *
+ * @return  0 if @p c is a NACK from another relay, 1 otherwise
+ */
+int nack_cache(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief   Answer an Interest for /<prefix>/<id>/gasval/<seq> with a NACK
+ *          if the relay would drop it
+ *
+ * Call from the local producer function for Interests not produced
+ * locally. NoRoute is sent if no FIB entry matches, Congestion if the PIT
+ * is full and the Interest can neither be aggregated nor be answered from
+ * the CS.
+ *
+ * @return  the reason sent or counted, NACK_NONE if the Interest passes
+ */
+nack_reason_t nack_check(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                         struct ccnl_pkt_s *pkt, const char *prefix);
+
+/**
+ * @brief   Parse and count a NACK Data's payload
+ *
+ * @param[out] id       producer name component, not terminated
+ * @param[out] seq      sequence number component, not terminated
+ *
+ * @return  the reason, NACK_NONE if @p data is no NACK
+ */
+nack_reason_t nack_parse(const unsigned char *data, size_t len,
+                         const unsigned char **id, size_t *id_len,
+                         const unsigned char **seq, size_t *seq_len);
+
+/**
+ * @brief   Shell command printing NACKs sent and received, "reset" clears
+ *          them
+ */
+int nack_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NACK_H */
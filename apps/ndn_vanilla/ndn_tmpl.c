@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msg.h"
+#include "random.h"
+#include "net/gnrc/netapi.h"
+
+#include "ccnl-pkt-builder.h"
+#include "ndn_tmpl.h"
+
+/* locate the sequence number (last name component), the nonce and the
+ * payload's sequence number */
+static int _parse(ndn_tmpl_t *tmpl, int pay_seq_offs)
+{
+    unsigned char *data = tmpl->buf;
+    int len = tmpl->len, pkt_typ, typ, vallen, seq_len = 0;
+
+    tmpl->seq_offs = -1;
+    tmpl->nonce_offs = -1;
+    tmpl->pay_seq_offs = -1;
+    if (ccnl_ndntlv_dehead(&data, &len, &pkt_typ, &vallen)) {
+        return -1;
+    }
+    while (len > 0) {
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) || vallen > len) {
+            return -1;
+        }
+        if (typ == NDN_TLV_Name) {
+            unsigned char *comp = data;
+            int comp_len = vallen, comp_typ, comp_vallen;
+
+            while (comp_len > 0) {
+                if (ccnl_ndntlv_dehead(&comp, &comp_len, &comp_typ, &comp_vallen) ||
+                    comp_vallen > comp_len) {
+                    return -1;
+                }
+                if (comp_typ == NDN_TLV_NameComponent) {
+                    tmpl->seq_offs = comp - tmpl->buf;
+                    seq_len = comp_vallen;
+                }
+                comp += comp_vallen;
+                comp_len -= comp_vallen;
+            }
+        }
+        else if ((pkt_typ == NDN_TLV_Interest) && (typ == NDN_TLV_Nonce) &&
+                 (vallen == sizeof(uint32_t))) {
+            tmpl->nonce_offs = data - tmpl->buf;
+        }
+        else if ((typ == NDN_TLV_Content) && (pay_seq_offs >= 0) &&
+                 (pay_seq_offs + NDN_TMPL_SEQ_WIDTH <= vallen)) {
+            tmpl->pay_seq_offs = (data - tmpl->buf) + pay_seq_offs;
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    if ((tmpl->seq_offs < 0) || (seq_len != NDN_TMPL_SEQ_WIDTH) ||
+        ((pkt_typ == NDN_TLV_Interest) && (tmpl->nonce_offs < 0)) ||
+        ((pay_seq_offs >= 0) && (tmpl->pay_seq_offs < 0))) {
+        return -1;
+    }
+    return 0;
+}
+
+static int _init(ndn_tmpl_t *tmpl, unsigned char *data, int len,
+                 int pay_seq_offs)
+{
+    tmpl->buf = malloc(len);
+    if (!tmpl->buf) {
+        return -1;
+    }
+    memcpy(tmpl->buf, data, len);
+    tmpl->len = len;
+    if (_parse(tmpl, pay_seq_offs) < 0) {
+        ndn_tmpl_free(tmpl);
+        return -1;
+    }
+    return 0;
+}
+
+int ndn_tmpl_data_init(ndn_tmpl_t *tmpl, char *uri,
+                       unsigned char *payload, int paylen, int pay_seq_offs)
+{
+    unsigned char out[NDN_TMPL_BUFSIZE];
+    int offs = sizeof(out);
+    struct ccnl_prefix_s *prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV,
+                                                    NULL, NULL);
+    if (!prefix) {
+        return -1;
+    }
+    int len = ccnl_ndntlv_prependContent(prefix, payload, paylen, NULL, NULL,
+                                         &offs, out);
+    ccnl_prefix_free(prefix);
+    if (len <= 0) {
+        return -1;
+    }
+    return _init(tmpl, out + offs, len, pay_seq_offs);
+}
+
+int ndn_tmpl_interest_init(ndn_tmpl_t *tmpl, struct ccnl_prefix_s *prefix)
+{
+    ccnl_interest_opts_u int_opts;
+    struct ccnl_prefix_s *name = ccnl_prefix_dup(prefix);
+    struct ccnl_buf_s *buf;
+    int res;
+
+    if (!name) {
+        return -1;
+    }
+    /* <prefix>/gasval/0000, the placeholder gets patched per request */
+    if ((ccnl_prefix_appendCmp(name, (unsigned char *)"gasval", 6) < 0) ||
+        (ccnl_prefix_appendCmp(name, (unsigned char *)"0000",
+                               NDN_TMPL_SEQ_WIDTH) < 0)) {
+        ccnl_prefix_free(name);
+        return -1;
+    }
+    memset(&int_opts, 0, sizeof(int_opts));
+    int_opts.ndntlv.nonce = random_uint32();
+    int_opts.ndntlv.interestlifetime = NDN_DEFAULT_INTEREST_LIFETIME;
+    buf = ccnl_mkSimpleInterest(name, &int_opts);
+    ccnl_prefix_free(name);
+    if (!buf) {
+        return -1;
+    }
+    res = _init(tmpl, buf->data, buf->datalen, -1);
+    ccnl_free(buf);
+    return res;
+}
+
+void ndn_tmpl_free(ndn_tmpl_t *tmpl)
+{
+    free(tmpl->buf);
+    tmpl->buf = NULL;
+    tmpl->len = 0;
+}
+
+/* same width as "%04u", so none of the length fields change */
+static void _put_seq(unsigned char *p, unsigned seq)
+{
+    for (int i = NDN_TMPL_SEQ_WIDTH - 1; i >= 0; i--) {
+        p[i] = '0' + (seq % 10);
+        seq /= 10;
+    }
+}
+
+struct ccnl_pkt_s *ndn_tmpl_pkt(ndn_tmpl_t *tmpl, unsigned seq)
+{
+    unsigned char *data = tmpl->buf;
+    int len = tmpl->len, typ, vallen;
+
+    if (seq > NDN_TMPL_SEQ_MAX) {
+        return NULL;
+    }
+    _put_seq(tmpl->buf + tmpl->seq_offs, seq);
+    if (tmpl->pay_seq_offs >= 0) {
+        _put_seq(tmpl->buf + tmpl->pay_seq_offs, seq);
+    }
+    if (tmpl->nonce_offs >= 0) {
+        uint32_t nonce = random_uint32();
+        memcpy(tmpl->buf + tmpl->nonce_offs, &nonce, sizeof(nonce));
+    }
+    if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+        return NULL;
+    }
+    return ccnl_ndntlv_bytes2pkt(typ, tmpl->buf, &data, &len);
+}
+
+int ndn_tmpl_interest_send(ndn_tmpl_t *tmpl, unsigned seq)
+{
+    struct ccnl_pkt_s *pkt = ndn_tmpl_pkt(tmpl, seq);
+    if (!pkt) {
+        return -1;
+    }
+    /* same hand-over as ccnl_send_interest(), minus the URI parsing */
+    msg_t m = { .type = GNRC_NETAPI_MSG_TYPE_SND, .content.ptr = pkt };
+    if (msg_send(&m, _ccnl_event_loop_pid) < 1) {
+        ccnl_pkt_free(pkt);
+        return -1;
+    }
+    return 0;
+}
+
+char *ndn_tmpl_name_to_str(ndn_tmpl_t *tmpl, char *buf, size_t len)
+{
+    unsigned char *data = tmpl->buf;
+    int data_len = tmpl->len, typ, vallen;
+    size_t pos = 0;
+
+    buf[0] = '\0';
+    if (ccnl_ndntlv_dehead(&data, &data_len, &typ, &vallen) ||
+        ccnl_ndntlv_dehead(&data, &data_len, &typ, &vallen) ||
+        (typ != NDN_TLV_Name)) {
+        return buf;
+    }
+    data_len = vallen;
+    while ((data_len > 0) && (pos < len)) {
+        if (ccnl_ndntlv_dehead(&data, &data_len, &typ, &vallen) ||
+            vallen > data_len) {
+            break;
+        }
+        pos += snprintf(buf + pos, len - pos, "/%.*s", vallen, (char *)data);
+        data += vallen;
+        data_len -= vallen;
+    }
+    return buf;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Pre-encoded NDN-TLV packet templates
+ *
+ * A template holds a complete NDN-TLV packet whose last name component is
+ * the 4-digit sequence number. Per request only that component (and the
+ * nonce of an Interest) is patched in place before the packet is handed to
+ * CCN-lite.
+ *
+ * @}
+ */
+
+#ifndef NDN_TMPL_H
+#define NDN_TMPL_H
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* upper bound for the encoded packet while building a template */
+#ifndef NDN_TMPL_BUFSIZE
+#define NDN_TMPL_BUFSIZE        (128)
+#endif
+
+/* width of the ASCII sequence number component (%04u) */
+#define NDN_TMPL_SEQ_WIDTH      (4)
+#define NDN_TMPL_SEQ_MAX        (9999u)
+
+typedef struct {
+    unsigned char *buf; /* encoded packet, allocated on init */
+    int len;            /* length of the encoded packet in buf */
+    int seq_offs;       /* offset of the sequence component's value in buf */
+    int nonce_offs;     /* offset of the nonce's value in buf, -1 for Data */
+    int pay_seq_offs;   /* offset of the payload's sequence number, or -1 */
+} ndn_tmpl_t;
+
+/**
+ * @brief   Encode a Data template for @p uri
+ *
+ * The last component of @p uri is the placeholder for the sequence number
+ * and must be NDN_TMPL_SEQ_WIDTH characters long. If @p pay_seq_offs is not
+ * negative, the payload carries a second placeholder of the same width at
+ * that offset.
+ *
+ * @return  0 on success, -1 on error
+ */
+int ndn_tmpl_data_init(ndn_tmpl_t *tmpl, char *uri,
+                       unsigned char *payload, int paylen, int pay_seq_offs);
+
+/**
+ * @brief   Encode an Interest template for <@p prefix>/gasval/<seq>
+ *
+ * @p prefix is typically a FIB entry's prefix and is not modified.
+ *
+ * @return  0 on success, -1 on error
+ */
+int ndn_tmpl_interest_init(ndn_tmpl_t *tmpl, struct ccnl_prefix_s *prefix);
+
+/**
+ * @brief   Release the memory held by a template
+ */
+void ndn_tmpl_free(ndn_tmpl_t *tmpl);
+
+/**
+ * @brief   Patch @p seq (and a fresh nonce) into the template and decode it
+ *
+ * @return  the packet, NULL if @p seq does not fit into the template
+ */
+struct ccnl_pkt_s *ndn_tmpl_pkt(ndn_tmpl_t *tmpl, unsigned seq);
+
+/**
+ * @brief   Patch @p seq into an Interest template and hand it to the relay
+ *
+ * @return  0 on success, -1 on error
+ */
+int ndn_tmpl_interest_send(ndn_tmpl_t *tmpl, unsigned seq);
+
+/**
+ * @brief   Write the template's current name as URI to @p buf
+ */
+char *ndn_tmpl_name_to_str(ndn_tmpl_t *tmpl, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NDN_TMPL_H */
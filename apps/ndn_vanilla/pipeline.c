@@ -0,0 +1,513 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "msg.h"
+#include "xtimer.h"
+#include "net/gnrc/netreg.h"
+#include "net/gnrc/pktbuf.h"
+
+#include "ccn-lite-riot.h"
+#ifdef NACK
+#include "nack.h"
+#endif
+#include "ndn_tmpl.h"
+#include "pipeline.h"
+
+#ifndef NUM_REQUESTS_NODE
+#define NUM_REQUESTS_NODE       (3600u)
+#endif
+
+#define PIPELINE_QUEUE_SIZE     (16)
+
+/* windows are kept in 1/CWND_SCALE Interests for the additive increase */
+#define CWND_SCALE              (8U)
+#define SLOT_FREE               (UINT16_MAX)
+
+typedef struct {
+    uint16_t seq;
+    uint8_t retries;            /* retransmissions of this Interest */
+    uint32_t first;             /* ms, first transmission */
+    uint32_t sent;              /* ms, last transmission */
+} _slot_t;
+
+typedef struct {
+    ndn_tmpl_t tmpl;
+    char tag[PIPELINE_TAG_LEN + 1];
+    _slot_t slot[PIPELINE_WINDOW_MAX];
+    uint16_t next_seq;
+    uint16_t recover_seq;       /* losses below this were already reacted on */
+    uint16_t cwnd;
+    uint8_t inflight;
+    uint32_t sent;
+    uint32_t rcvd;
+    uint32_t timeouts;
+    uint32_t late;              /* Data for Interests that already timed out */
+#ifdef NACK
+    uint32_t nacked;            /* Interests given up on a NACK */
+#endif
+#ifdef RTT_ESTIMATOR
+    uint32_t srtt;              /* ms */
+    uint32_t rttvar;            /* ms */
+    uint32_t rto;               /* ms */
+    uint32_t samples;
+    uint32_t retrans;
+#endif
+    uint32_t lat_sum;           /* ms, first transmission to Data */
+    uint32_t lat_max;           /* ms */
+    uint32_t recovered;         /* Data that needed a retransmission */
+    uint32_t rec_sum;           /* ms, latency of those */
+} _producer_t;
+
+static _producer_t _producers[PIPELINE_PRODUCER_NUMOF];
+static unsigned _producers_num;
+static unsigned _inflight;
+static unsigned _rr;
+static msg_t _msg_queue[PIPELINE_QUEUE_SIZE];
+#ifdef RTT_ESTIMATOR
+static bool _reexpress;
+#endif
+
+static inline uint32_t _now_ms(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_MS);
+}
+
+static inline unsigned _window(_producer_t *p)
+{
+    return p->cwnd / CWND_SCALE;
+}
+
+#ifdef RTT_ESTIMATOR
+/* RFC 6298 with alpha = 1/8, beta = 1/4, K = 4 and G = PIPELINE_TICK_MS */
+static void _rtt_sample(_producer_t *p, uint32_t rtt)
+{
+    if (!p->samples) {
+        p->srtt = rtt;
+        p->rttvar = rtt / 2;
+    }
+    else {
+        uint32_t delta = (p->srtt > rtt) ? (p->srtt - rtt) : (rtt - p->srtt);
+        p->rttvar = ((3 * p->rttvar) + delta) / 4;
+        p->srtt = ((7 * p->srtt) + rtt) / 8;
+    }
+    p->samples++;
+    p->rto = p->srtt + ((4 * p->rttvar > PIPELINE_TICK_MS) ? (4 * p->rttvar)
+                                                          : PIPELINE_TICK_MS);
+    if (p->rto < PIPELINE_RTO_MIN_MS) {
+        p->rto = PIPELINE_RTO_MIN_MS;
+    }
+    else if (p->rto > PIPELINE_RTO_MAX_MS) {
+        p->rto = PIPELINE_RTO_MAX_MS;
+    }
+}
+
+/* CCN-lite forwards an Interest matching a pending PIT entry again only if
+ * it came in on a face flagged FWDALLI, otherwise it just adds the face to
+ * the entry. Flag the loopback face the app's Interests come from, created
+ * by ccnl_start() with ifndx -1. */
+static bool _fwdalli(void)
+{
+    for (struct ccnl_face_s *f = ccnl_relay.faces; f; f = f->next) {
+        if (f->ifndx < 0) {
+            f->flags |= CCNL_FACE_FLAGS_FWDALLI;
+            return true;
+        }
+    }
+    puts("Warning: no loopback face, Interests are not re-expressed");
+    return false;
+}
+
+/* exponential backoff per retransmission of the slot */
+static uint32_t _timeout(_producer_t *p, _slot_t *slot)
+{
+    uint32_t rto = p->rto << slot->retries;
+
+    return (rto > PIPELINE_RTO_MAX_MS) ? PIPELINE_RTO_MAX_MS : rto;
+}
+#else
+static inline uint32_t _timeout(_producer_t *p, _slot_t *slot)
+{
+    (void)p;
+    (void)slot;
+    return PIPELINE_TIMEOUT_MS;
+}
+#endif
+
+void pipeline_tag(const char *hwaddr, int len, char *tag)
+{
+    int pos = PIPELINE_TAG_LEN;
+
+    tag[pos] = '\0';
+    for (int i = len - 1; (i >= 0) && (pos > 0); i--) {
+        if (hwaddr[i] != ':') {
+            tag[--pos] = hwaddr[i];
+        }
+    }
+    while (pos > 0) {
+        tag[--pos] = '0';
+    }
+}
+
+static void _init(void)
+{
+    struct ccnl_forward_s *fwd;
+
+    _producers_num = 0;
+    _inflight = 0;
+    _rr = 0;
+#ifdef RTT_ESTIMATOR
+    _reexpress = _fwdalli();
+#endif
+    for (fwd = ccnl_relay.fib; fwd && (_producers_num < PIPELINE_PRODUCER_NUMOF);
+         fwd = fwd->next) {
+        _producer_t *p = &_producers[_producers_num];
+
+        /* /PREFIX/hwaddr as it comes from cb_published() */
+        if (fwd->prefix->compcnt < 2) {
+            continue;
+        }
+        memset(p, 0, sizeof(*p));
+        if (ndn_tmpl_interest_init(&p->tmpl, fwd->prefix) < 0) {
+            puts("ERROR building interest template");
+            continue;
+        }
+        pipeline_tag((char *)fwd->prefix->comp[1], fwd->prefix->complen[1],
+                     p->tag);
+        for (unsigned i = 0; i < PIPELINE_WINDOW_MAX; i++) {
+            p->slot[i].seq = SLOT_FREE;
+        }
+        p->cwnd = CWND_SCALE;
+#ifdef RTT_ESTIMATOR
+        p->rto = PIPELINE_RTO_INIT_MS;
+#endif
+        _producers_num++;
+    }
+}
+
+static int _send(_producer_t *p)
+{
+    _slot_t *slot = NULL;
+
+    for (unsigned i = 0; i < PIPELINE_WINDOW_MAX; i++) {
+        if (p->slot[i].seq == SLOT_FREE) {
+            slot = &p->slot[i];
+            break;
+        }
+    }
+    if (!slot) {
+        return -1;
+    }
+#ifdef MODULE_PKTCNT_FAST
+    uint64_t now = xtimer_now_usec64();
+#endif
+    if (ndn_tmpl_interest_send(&p->tmpl, p->next_seq) < 0) {
+        return -1;
+    }
+#ifdef MODULE_PKTCNT_FAST
+    char req_uri[40];
+    printf("PUB;%s;%lu%06lu\n",
+        ndn_tmpl_name_to_str(&p->tmpl, req_uri, sizeof(req_uri)),
+        (unsigned long)div_u64_by_1000000(now),
+        (unsigned long)now % US_PER_SEC);
+#endif
+    slot->seq = p->next_seq++;
+    slot->retries = 0;
+    slot->first = slot->sent = _now_ms();
+    p->inflight++;
+    p->sent++;
+    _inflight++;
+    return 0;
+}
+
+/* fill the windows round-robin so no producer starves under the global cap */
+static void _fill(void)
+{
+    bool progress = true;
+
+    while (progress && (_inflight < PIPELINE_INFLIGHT_MAX)) {
+        progress = false;
+        for (unsigned n = 0; n < _producers_num; n++) {
+            _producer_t *p = &_producers[_rr];
+
+            if (_inflight >= PIPELINE_INFLIGHT_MAX) {
+                break;
+            }
+            _rr = (_rr + 1) % _producers_num;
+            if ((p->next_seq < NUM_REQUESTS_NODE) &&
+                (p->inflight < _window(p)) && (_send(p) == 0)) {
+                progress = true;
+            }
+        }
+    }
+}
+
+static _slot_t *_find_slot(_producer_t *p, unsigned seq)
+{
+    for (unsigned i = 0; i < PIPELINE_WINDOW_MAX; i++) {
+        if (p->slot[i].seq == seq) {
+            return &p->slot[i];
+        }
+    }
+    return NULL;
+}
+
+static void _release(_producer_t *p, _slot_t *slot)
+{
+    slot->seq = SLOT_FREE;
+    p->inflight--;
+    _inflight--;
+}
+
+static void _on_data(_producer_t *p, unsigned seq)
+{
+    _slot_t *slot = _find_slot(p, seq);
+    uint32_t now = _now_ms(), lat;
+
+    if (!slot) {
+        p->late++;
+        return;
+    }
+    lat = now - slot->first;
+    p->lat_sum += lat;
+    if (lat > p->lat_max) {
+        p->lat_max = lat;
+    }
+    if (slot->retries) {
+        p->recovered++;
+        p->rec_sum += lat;
+    }
+#ifdef RTT_ESTIMATOR
+    /* Karn: a retransmitted Interest gives an ambiguous sample */
+    else {
+        _rtt_sample(p, now - slot->sent);
+    }
+#endif
+    _release(p, slot);
+    p->rcvd++;
+    /* additive increase: about one Interest per window of Data */
+    p->cwnd += (CWND_SCALE * CWND_SCALE) / p->cwnd;
+    if (p->cwnd > PIPELINE_WINDOW_MAX * CWND_SCALE) {
+        p->cwnd = PIPELINE_WINDOW_MAX * CWND_SCALE;
+    }
+}
+
+/* multiplicative decrease, only once per window of losses */
+static void _decrease(_producer_t *p, unsigned seq)
+{
+    if (seq >= p->recover_seq) {
+        p->cwnd /= 2;
+        if (p->cwnd < CWND_SCALE) {
+            p->cwnd = CWND_SCALE;
+        }
+        p->recover_seq = p->next_seq;
+    }
+}
+
+static void _on_timeout(_producer_t *p, _slot_t *slot)
+{
+    unsigned seq = slot->seq;
+
+    _decrease(p, seq);
+#ifdef RTT_ESTIMATOR
+    /* re-express the Interest, the relay propagates it again even though the
+     * PIT entry is still pending as the loopback face is flagged FWDALLI */
+    if (_reexpress && (slot->retries < PIPELINE_RETRIES) &&
+        (ndn_tmpl_interest_send(&p->tmpl, seq) == 0)) {
+        slot->retries++;
+        slot->sent = _now_ms();
+        p->retrans++;
+        return;
+    }
+#endif
+    _release(p, slot);
+    p->timeouts++;
+}
+
+static void _check_timeouts(void)
+{
+    uint32_t now = _now_ms();
+
+    for (unsigned i = 0; i < _producers_num; i++) {
+        _producer_t *p = &_producers[i];
+
+        for (unsigned j = 0; j < PIPELINE_WINDOW_MAX; j++) {
+            _slot_t *slot = &p->slot[j];
+            if ((slot->seq != SLOT_FREE) &&
+                ((now - slot->sent) >= _timeout(p, slot))) {
+                _on_timeout(p, slot);
+            }
+        }
+    }
+}
+
+static _producer_t *_find_producer(const char *tag)
+{
+    for (unsigned i = 0; i < _producers_num; i++) {
+        if (!memcmp(_producers[i].tag, tag, PIPELINE_TAG_LEN)) {
+            return &_producers[i];
+        }
+    }
+    return NULL;
+}
+
+#ifdef NACK
+/* a relay cannot get the Data, back off right away instead of waiting for
+ * the timeout */
+static void _handle_nack(const unsigned char *id, size_t id_len,
+                         const unsigned char *seq_str, size_t seq_len)
+{
+    char tag[PIPELINE_TAG_LEN + 1];
+    unsigned seq = 0;
+    _producer_t *p;
+    _slot_t *slot;
+
+    pipeline_tag((const char *)id, id_len, tag);
+    for (size_t i = 0; (i < seq_len) && (seq_str[i] >= '0') && (seq_str[i] <= '9');
+         i++) {
+        seq = (seq * 10) + (seq_str[i] - '0');
+    }
+    p = _find_producer(tag);
+    if (!p || !(slot = _find_slot(p, seq))) {
+        return;
+    }
+    _decrease(p, seq);
+    _release(p, slot);
+    p->nacked++;
+}
+#endif
+
+/* {"id":"0x<tag>","val":<seq>} */
+static void _handle_chunk(const char *data, size_t len)
+{
+    static const char id_key[] = "{\"id\":\"0x";
+    static const char val_key[] = "\",\"val\":";
+    const size_t seq_pos = (sizeof(id_key) - 1) + PIPELINE_TAG_LEN +
+                           (sizeof(val_key) - 1);
+    unsigned seq = 0;
+    _producer_t *p;
+
+#ifdef NACK
+    const unsigned char *id, *seq_str;
+    size_t id_len, seq_len;
+    if (nack_parse((const unsigned char *)data, len, &id, &id_len,
+                   &seq_str, &seq_len) != NACK_NONE) {
+        _handle_nack(id, id_len, seq_str, seq_len);
+        return;
+    }
+#endif
+    if ((len <= seq_pos) ||
+        memcmp(data, id_key, sizeof(id_key) - 1) ||
+        memcmp(data + seq_pos - (sizeof(val_key) - 1), val_key,
+               sizeof(val_key) - 1)) {
+        return;
+    }
+    for (size_t i = seq_pos; (i < len) && (data[i] >= '0') && (data[i] <= '9');
+         i++) {
+        seq = (seq * 10) + (data[i] - '0');
+    }
+    p = _find_producer(data + sizeof(id_key) - 1);
+    if (p) {
+        _on_data(p, seq);
+    }
+}
+
+static bool _done(void)
+{
+    for (unsigned i = 0; i < _producers_num; i++) {
+        if ((_producers[i].next_seq < NUM_REQUESTS_NODE) ||
+            _producers[i].inflight) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void *pipeline_event_loop(void *arg)
+{
+    (void)arg;
+    gnrc_netreg_entry_t ne = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                        sched_active_pid);
+
+    msg_init_queue(_msg_queue, PIPELINE_QUEUE_SIZE);
+    /* register for content chunks handed up by ccnl_app_RX() */
+    gnrc_netreg_register(GNRC_NETTYPE_CCN_CHUNK, &ne);
+
+    _init();
+    if (!_producers_num) {
+        puts("Warning: no producers in FIB");
+    }
+    _fill();
+    while (!_done()) {
+        msg_t msg;
+        if ((xtimer_msg_receive_timeout(&msg, PIPELINE_TICK_MS * US_PER_MS) >= 0) &&
+            (msg.type == GNRC_NETAPI_MSG_TYPE_RCV)) {
+            gnrc_pktsnip_t *pkt = msg.content.ptr;
+            _handle_chunk(pkt->data, pkt->size);
+            gnrc_pktbuf_release(pkt);
+        }
+        _check_timeouts();
+        _fill();
+    }
+    gnrc_netreg_unregister(GNRC_NETTYPE_CCN_CHUNK, &ne);
+    for (unsigned i = 0; i < _producers_num; i++) {
+        ndn_tmpl_free(&_producers[i].tmpl);
+    }
+    puts("PIPELINE DONE");
+    return NULL;
+}
+
+int pipeline_stats(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    /* PL;<tag>;<window>;<outstanding>;<sent>;<received>;<timeouts>;<late>
+     *    [;<nacked>] */
+    for (unsigned i = 0; i < _producers_num; i++) {
+        _producer_t *p = &_producers[i];
+        printf("PL;%s;%u.%u;%u;%lu;%lu;%lu;%lu", p->tag,
+               p->cwnd / CWND_SCALE, ((p->cwnd % CWND_SCALE) * 10) / CWND_SCALE,
+               p->inflight, (unsigned long)p->sent, (unsigned long)p->rcvd,
+               (unsigned long)p->timeouts, (unsigned long)p->late);
+#ifdef NACK
+        printf(";%lu", (unsigned long)p->nacked);
+#endif
+        puts("");
+    }
+    printf("PL;outstanding;%u\n", _inflight);
+    return 0;
+}
+
+int pipeline_rto(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    /* RTO;<tag>;<srtt>;<rttvar>;<rto>;<samples>;<retransmissions>;
+     *     <avg latency>;<max latency>;<recovered>;<avg recovery latency> */
+    for (unsigned i = 0; i < _producers_num; i++) {
+        _producer_t *p = &_producers[i];
+#ifdef RTT_ESTIMATOR
+        printf("RTO;%s;%lu;%lu;%lu;%lu;%lu;", p->tag, (unsigned long)p->srtt,
+               (unsigned long)p->rttvar, (unsigned long)p->rto,
+               (unsigned long)p->samples, (unsigned long)p->retrans);
+#else
+        printf("RTO;%s;-;-;%lu;0;0;", p->tag,
+               (unsigned long)PIPELINE_TIMEOUT_MS);
+#endif
+        printf("%lu;%lu;%lu;%lu\n",
+               (unsigned long)(p->rcvd ? p->lat_sum / p->rcvd : 0),
+               (unsigned long)p->lat_max, (unsigned long)p->recovered,
+               (unsigned long)(p->recovered ? p->rec_sum / p->recovered : 0));
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Windowed Interest pipeline for the ndn_vanilla consumer
+ *
+ * Every producer in the FIB gets its own window of outstanding Interests.
+ * The window grows by one Interest per round trip while Data arrives and is
+ * halved on a timeout (AIMD). Data is matched to its request by the producer
+ * tag and sequence number the producers put into the payload.
+ *
+ * With RTT_ESTIMATOR, every producer keeps an SRTT/RTTVAR estimate (RFC 6298)
+ * and Interests are re-expressed after the estimated RTO with exponential
+ * backoff instead of waiting for the static PIPELINE_TIMEOUT_MS. The app's
+ * loopback face gets CCNL_FACE_FLAGS_FWDALLI, without it the relay would
+ * only add a re-expressed Interest to its pending PIT entry and send nothing.
+ *
+ * @}
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum number of producers served by the pipeline */
+#ifndef PIPELINE_PRODUCER_NUMOF
+#define PIPELINE_PRODUCER_NUMOF     (50)
+#endif
+
+/* upper bound of a single producer's window */
+#ifndef PIPELINE_WINDOW_MAX
+#define PIPELINE_WINDOW_MAX         (4)
+#endif
+
+/* upper bound of Interests outstanding over all producers, keeps the relay's
+ * message queue and PIT from overflowing */
+#ifndef PIPELINE_INFLIGHT_MAX
+#define PIPELINE_INFLIGHT_MAX       (CCNL_QUEUE_SIZE / 2)
+#endif
+
+/* time after which an outstanding Interest counts as lost, unless the
+ * RTT_ESTIMATOR derives it per producer */
+#ifndef PIPELINE_TIMEOUT_MS
+#define PIPELINE_TIMEOUT_MS         (NDN_DEFAULT_INTEREST_LIFETIME)
+#endif
+
+#ifdef RTT_ESTIMATOR
+/* RTO before the first RTT sample of a producer (RFC 6298: 1 s) */
+#ifndef PIPELINE_RTO_INIT_MS
+#define PIPELINE_RTO_INIT_MS        (1000)
+#endif
+
+/* bounds of the estimated RTO, backoff included */
+#ifndef PIPELINE_RTO_MIN_MS
+#define PIPELINE_RTO_MIN_MS         (200)
+#endif
+#ifndef PIPELINE_RTO_MAX_MS
+#define PIPELINE_RTO_MAX_MS         (NDN_DEFAULT_INTEREST_LIFETIME)
+#endif
+
+/* retransmissions of an Interest before it counts as lost */
+#ifndef PIPELINE_RETRIES
+#define PIPELINE_RETRIES            (CCNL_MAX_INTEREST_RETRANSMIT)
+#endif
+#endif
+
+/* how often outstanding Interests are checked for timeouts */
+#ifndef PIPELINE_TICK_MS
+#define PIPELINE_TICK_MS            (100)
+#endif
+
+/* producer tag in the payload: the last 10 hex digits of the hwaddr */
+#define PIPELINE_TAG_LEN            (10)
+
+/* payload of a tagged Data, same size as the default i3 payload */
+#define PIPELINE_PAYLOAD_FMT        "{\"id\":\"0x%s\",\"val\":%04u}"
+
+/**
+ * @brief   Derive a producer's payload tag from its hwaddr string
+ *
+ * @param[in] hwaddr    colon separated hex string, need not be terminated
+ * @param[in] len       length of @p hwaddr
+ * @param[out] tag      PIPELINE_TAG_LEN + 1 bytes
+ */
+void pipeline_tag(const char *hwaddr, int len, char *tag);
+
+/**
+ * @brief   Consumer thread driving the pipeline for all FIB entries
+ */
+void *pipeline_event_loop(void *arg);
+
+/**
+ * @brief   Shell command printing the per-producer pipeline state
+ */
+int pipeline_stats(int argc, char **argv);
+
+/**
+ * @brief   Shell command printing the per-producer RTO and Data latencies
+ */
+int pipeline_rto(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_H */
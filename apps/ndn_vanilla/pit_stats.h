@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       PIT occupancy, aggregation and expiration counters
+ *
+ * Every Interest the relay receives is sampled from the local producer hook,
+ * i.e. in the relay thread right before the relay searches its PIT. A sample
+ * walks the PIT the same way the relay does, so the counters also show how
+ * many entries the relay compares per Interest. An Interest matching an
+ * entry that is pending for other faces is aggregated, one matching an entry
+ * already pending for its own face is a retransmission.
+ *
+ * Entries are counted from the PIT size around calls wrapped at link time.
+ * Those ccnl_content_serve_pending() removes were satisfied, and
+ * ccnl_interest_new() counts the entries created. All other entries that
+ * left the PIT expired. ccnl_interest_remove() cannot be wrapped for this,
+ * because the relay module calls it internally and --wrap only redirects
+ * calls between object files.
+ *
+ * @}
+ */
+
+#ifndef PIT_STATS_H
+#define PIT_STATS_H
+
+#include "ccn-lite-riot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Sample the PIT for the Interest @p pkt received on @p from
+ *
+ * Must be called from the relay thread.
+ */
+void pit_stats_sample(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief   Shell command printing the PIT counters, "reset" clears them
+ */
+int pit_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIT_STATS_H */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Prioritised receive queue in front of the CCN-lite relay
+ *
+ * Takes over the relay's GNRC_NETTYPE_CCN registration, sorts every
+ * received frame into one of three classes by its outermost TLV type and
+ * hands them to the relay one at a time, HoPP control first, then Data,
+ * then Interests. Each class has its own bounded queue and drops new frames
+ * when it is full.
+ *
+ * The thread runs one priority below the relay, so it only hands over a
+ * frame while the relay waits for work, and frames wait here, where they
+ * can be reordered, instead of in the relay's FIFO. Timer events, HoPP's
+ * own messages and requests from local threads still go to the relay
+ * directly.
+ *
+ * @}
+ */
+
+#ifndef RELAY_Q_H
+#define RELAY_Q_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* frames queued per class */
+#ifndef RELAY_Q_CTRL_SIZE
+#define RELAY_Q_CTRL_SIZE       (8)
+#endif
+#ifndef RELAY_Q_DATA_SIZE
+#define RELAY_Q_DATA_SIZE       (16)
+#endif
+#ifndef RELAY_Q_INTEREST_SIZE
+#define RELAY_Q_INTEREST_SIZE   (16)
+#endif
+
+/* messages not yet sorted, must be a power of two */
+#ifndef RELAY_Q_MBOX_SIZE
+#define RELAY_Q_MBOX_SIZE       (32)
+#endif
+
+#ifndef RELAY_Q_PRIO
+#define RELAY_Q_PRIO            (CCNL_THREAD_PRIORITY + 1)
+#endif
+
+/**
+ * @brief   Move the relay's registration to the queue thread
+ *
+ * Call after ccnl_open_netif().
+ *
+ * @return  0 on success, -1 on error
+ */
+int relay_q_init(void);
+
+/**
+ * @brief   Shell command printing frames queued and dropped per class,
+ *          "reset" clears them
+ */
+int relay_q_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_Q_H */
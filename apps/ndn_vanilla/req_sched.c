@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "evtimer_msg.h"
+#include "msg.h"
+#include "random.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "req_sched.h"
+
+#define REQ_SCHED_MSG_TYPE      (0x5253)
+
+typedef struct {
+    evtimer_msg_event_t event;
+    uint64_t due;               /* us */
+    unsigned idx;
+    unsigned count;
+} _req_event_t;
+
+typedef struct {
+    uint32_t num;
+    uint64_t late_sum;          /* us */
+    uint32_t late_max;
+    uint64_t send_sum;          /* us */
+    uint32_t send_max;
+} _stats_t;
+
+static evtimer_t _timer;
+static _req_event_t _events[REQ_SCHED_NUMOF];
+static msg_t _queue[REQ_SCHED_QUEUE_SIZE];
+static _stats_t _stats;
+
+static void _add(_req_event_t *e, uint64_t due, uint64_t now)
+{
+    /* evtimer counts in ms, round up so the timer does not fire early. The
+     * exact deadline is kept, so the remainder does not add up over the
+     * periods. */
+    uint32_t offset = (due > now) ?
+                      (uint32_t)((due - now + US_PER_MS - 1) / US_PER_MS) : 0;
+
+    e->due = due;
+    e->event.event.offset = offset;
+    evtimer_add_msg(&_timer, &e->event, sched_active_pid);
+}
+
+void req_sched_run(unsigned num, req_sched_send_t send,
+                   req_sched_period_t period)
+{
+    unsigned active = 0;
+    uint64_t now;
+
+    if (num > REQ_SCHED_NUMOF) {
+        printf("Warning: only scheduling %u of %u producers\n",
+               (unsigned)REQ_SCHED_NUMOF, num);
+        num = REQ_SCHED_NUMOF;
+    }
+    msg_init_queue(_queue, REQ_SCHED_QUEUE_SIZE);
+    evtimer_init_msg(&_timer);
+
+    /* spread the first requests over one period */
+    now = xtimer_now_usec64();
+    for (unsigned i = 0; i < num; i++) {
+        _req_event_t *e = &_events[i];
+
+        e->idx = i;
+        e->count = 0;
+        e->event.msg.type = REQ_SCHED_MSG_TYPE;
+        e->event.msg.content.ptr = e;
+        _add(e, now + random_uint32_range(0, period()), now);
+        active++;
+    }
+    while (active) {
+        msg_t msg;
+        msg_receive(&msg);
+        if (msg.type != REQ_SCHED_MSG_TYPE) {
+            continue;
+        }
+        _req_event_t *e = msg.content.ptr;
+        uint32_t late, dur;
+
+        now = xtimer_now_usec64();
+        late = (now > e->due) ? (uint32_t)(now - e->due) : 0;
+        /* next deadline before sending, a slow send must not shift it */
+        _add(e, e->due + period(), now);
+        if (!send(e->idx, e->count++)) {
+            evtimer_del(&_timer, &e->event.event);
+            active--;
+            continue;
+        }
+        dur = (uint32_t)(xtimer_now_usec64() - now);
+        _stats.num++;
+        _stats.late_sum += late;
+        _stats.send_sum += dur;
+        if (late > _stats.late_max) {
+            _stats.late_max = late;
+        }
+        if (dur > _stats.send_max) {
+            _stats.send_max = dur;
+        }
+    }
+}
+
+int req_sched_stats(int argc, char **argv)
+{
+    if ((argc > 1) && !strcmp(argv[1], "reset")) {
+        memset(&_stats, 0, sizeof(_stats));
+        return 0;
+    }
+    uint32_t n = _stats.num ? _stats.num : 1;
+
+    /* SCHED;<requests>;<avg late us>;<max late us>;<avg send us>;<max send us> */
+    printf("SCHED;%lu;%lu;%lu;%lu;%lu\n", (unsigned long)_stats.num,
+           (unsigned long)(_stats.late_sum / n), (unsigned long)_stats.late_max,
+           (unsigned long)(_stats.send_sum / n), (unsigned long)_stats.send_max);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018 HAW Hamburg
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       evtimer driven per-producer request scheduler
+ *
+ * Every producer gets its own evtimer_msg_event_t, like the servers in
+ * coap_get_cli_sched's req_gen(). A producer's next deadline follows from
+ * its previous deadline, not from the time its request went out, so a slow
+ * send neither delays other producers nor lets the schedule drift. The time
+ * between deadline and dispatch is recorded as lateness.
+ *
+ * @}
+ */
+
+#ifndef REQ_SCHED_H
+#define REQ_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maximum number of producers scheduled */
+#ifndef REQ_SCHED_NUMOF
+#define REQ_SCHED_NUMOF         (50)
+#endif
+
+/* message queue of the scheduling thread, a power of two that holds all
+ * events firing at once */
+#ifndef REQ_SCHED_QUEUE_SIZE
+#define REQ_SCHED_QUEUE_SIZE    (64)
+#endif
+
+/**
+ * @brief   Send the next request to producer @p idx
+ *
+ * @param[in] idx       producer index, 0 to num - 1
+ * @param[in] count     number of previous calls for @p idx
+ *
+ * @return  false if @p idx has nothing left to request, nothing was sent
+ */
+typedef bool (*req_sched_send_t)(unsigned idx, unsigned count);
+
+/**
+ * @brief   Time between two requests to the same producer in us
+ */
+typedef uint32_t (*req_sched_period_t)(void);
+
+/**
+ * @brief   Schedule requests to @p num producers until all are done
+ *
+ * Runs in and blocks the calling thread, which must not have a message
+ * queue yet. @p send must not receive messages itself, it would take the
+ * scheduler's events.
+ */
+void req_sched_run(unsigned num, req_sched_send_t send,
+                   req_sched_period_t period);
+
+/**
+ * @brief   Shell command printing the scheduling lateness, "reset" clears it
+ */
+int req_sched_stats(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REQ_SCHED_H */